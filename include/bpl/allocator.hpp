@@ -32,6 +32,10 @@ concept Allocator =
 	{ allocator.deallocate(block, alignment) };
 };
 
+/// An allocator that can try to extend a block of memory in-place.
+///
+/// `try_grow` returns the extended block, which begins at the same address as the original one, or an empty block if
+/// the block can't be extended in-place; in that case the original block is left untouched.
 template<typename A>
 concept GrowableAllocator =
 	Allocator<A>
@@ -39,6 +43,9 @@ concept GrowableAllocator =
 		{ allocator.try_grow(block, alignment, additional) } -> std::same_as<MemoryBlock>;
 	};
 
+/// An allocator that can try to shrink a block of memory in-place.
+///
+/// `try_shrink` returns `true` if the block now has a size of `new_size` bytes; otherwise the block is left untouched.
 template<typename A>
 concept ShrinkableAllocator =
 	Allocator<A>
@@ -49,6 +56,41 @@ concept ShrinkableAllocator =
 template<typename A>
 concept ResizableAllocator = GrowableAllocator<A> && ShrinkableAllocator<A>;
 
+/// An allocator that can resize a block of memory like `realloc`, possibly moving it to a different address.
+///
+/// `reallocate` returns the resized block, whose content is the bytes of the original block up to the smaller of the
+/// two sizes, or an empty block on failure; in that case the original block is left untouched. It may move the bytes
+/// without copying them, so it can be used only with trivially relocatable types.
+template<typename A>
+concept ReallocatableAllocator =
+	Allocator<A>
+	&& requires(A& allocator, MemoryBlock block, size_t alignment, size_t new_size) {
+		{ allocator.reallocate(block, alignment, new_size) } -> std::same_as<MemoryBlock>;
+	};
+
+/// An allocator that can tell if a block of memory was allocated by it.
+///
+/// `owns` returns `true` if `block` lies in the memory managed by the allocator.
+template<typename A>
+concept OwningAllocator =
+	Allocator<A>
+	&& requires(const A& allocator, MemoryBlock block) {
+		{ allocator.owns(block) } -> std::same_as<bool>;
+	};
+
+/// An allocator that can allocate and deallocate many blocks of the same size at once.
+///
+/// `allocate_batch` writes `count` blocks of `size` bytes aligned to `alignment` to `blocks` and returns `true`, or
+/// returns `false` and allocates nothing. `deallocate_batch` deallocates `count` blocks, which were returned by
+/// `allocate` or `allocate_batch`.
+template<typename A>
+concept BatchAllocator =
+	Allocator<A>
+	&& requires(A& allocator, size_t size, size_t alignment, size_t count, MemoryBlock* blocks) {
+		{ allocator.allocate_batch(size, alignment, count, blocks) } -> std::same_as<bool>;
+		{ allocator.deallocate_batch(blocks, count, alignment) };
+	};
+
 // clang-format on
 
 /// @}
@@ -62,7 +104,7 @@ struct GlobalAllocator {
 	/// @{
 
 	static auto allocate(size_t size, size_t alignment) -> MemoryBlock {
-		BPL_DEBUG_ASSERT(alignment % 2 == 0);
+		BPL_DEBUG_ASSERT(is_pow2(alignment));
 		// From malloc(3): "aligned_alloc() returns a NULL pointer [...] if alignment is not a power of 2 at least as large as sizeof(void*)"
 		alignment = bpl::max(sizeof(void*), alignment);
 		size_t aligned_size = align_forward(size, alignment);
@@ -77,7 +119,14 @@ struct GlobalAllocator {
 };
 
 /// A stateless allocator that uses `mmap`.
-struct PagesAllocator {
+///
+/// @tparam H The kind of pages that back the blocks. With huge pages, blocks are aligned to `get_huge_page_size()`
+/// and their size is rounded up to a multiple of it.
+/// @tparam Prefault If `true`, the pages of each block are populated with `prefault_memory` when they're allocated,
+/// so that the first access to each page doesn't take a page fault.
+/// @tparam Numa The NUMA policy of each block, see `try_set_numa_policy`.
+template<HugePages H = HugePages::none, bool Prefault = false, NumaPolicy Numa = NumaPolicy{}>
+struct BasicPagesAllocator {
 	/// @name Allocator API
 	/// @{
 
@@ -85,16 +134,229 @@ struct PagesAllocator {
 	///   - `alignment` is less or equal to the page size
 	static auto allocate(size_t size, size_t alignment) -> MemoryBlock {
 		BPL_DEBUG_ASSERT(alignment <= get_page_size());
-		MemoryBlock block = reserve_memory(size);
+		MemoryBlock block = reserve_memory(size, H, Numa);
 		BPL_ASSERT(try_commit_memory(block));
+		if constexpr (Prefault) {
+			prefault_memory(block);
+		}
 		return block;
 	}
 
 	static void deallocate(MemoryBlock block, size_t /*alignment*/) { BPL_ASSERT(try_release_memory(block)); }
 
+	/// Remaps the pages of `block` instead of copying them, when supported by the OS.
+	///
+	/// @pre
+	///   - `alignment` is less or equal to the page size
+	static auto reallocate(MemoryBlock block, size_t alignment, size_t new_size) -> MemoryBlock {
+		BPL_DEBUG_ASSERT(alignment <= get_page_size());
+		if constexpr (H != HugePages::none) {
+			new_size = align_forward(new_size, get_huge_page_size());
+		}
+		MemoryBlock new_block = try_remap_memory(block, new_size);
+		if constexpr (Prefault) {
+			if (new_block.size > block.size) {
+				prefault_memory(
+					{ .ptr = static_cast<char*>(new_block.ptr) + block.size, .size = new_block.size - block.size }
+				);
+			}
+		}
+		return new_block;
+	}
+
+	/// @}
+};
+
+/// A stateless allocator of regular pages.
+using PagesAllocator = BasicPagesAllocator<>;
+
+/// A stateless allocator of transparent huge pages, for large blocks that suffer from TLB misses.
+using HugePagesAllocator = BasicPagesAllocator<HugePages::transparent>;
+
+/// @}
+
+/// @name Allocator adaptors
+/// @{
+
+/// A non-owning handle to an allocator, so that many containers can allocate from the same allocator.
+///
+/// It forwards every call to the referenced allocator and supports the same extensions, so it satisfies
+/// `GrowableAllocator`, `ShrinkableAllocator`, `ReallocatableAllocator` and `BatchAllocator` when `A` does. The
+/// referenced allocator must outlive the handle and every container that uses it.
+template<Allocator A>
+class AllocatorRef {
+public:
+	/// @name Constructors
+	/// @{
+
+	/// Refers to `allocator`.
+	explicit AllocatorRef(A& allocator) : m_allocator(&allocator) {}
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the referenced allocator.
+	[[nodiscard]]
+	auto get() const -> A& {
+		return *m_allocator;
+	}
+
+	/// Returns `true` if both handles refer to the same allocator.
+	friend auto operator==(AllocatorRef lhs, AllocatorRef rhs) -> bool { return lhs.m_allocator == rhs.m_allocator; }
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) const -> MemoryBlock {
+		return m_allocator->allocate(size, alignment);
+	}
+
+	void deallocate(MemoryBlock block, size_t alignment) const { m_allocator->deallocate(block, alignment); }
+
+	[[nodiscard]]
+	auto try_grow(MemoryBlock block, size_t alignment, size_t additional) const -> MemoryBlock
+	requires GrowableAllocator<A>
+	{
+		return m_allocator->try_grow(block, alignment, additional);
+	}
+
+	[[nodiscard]]
+	auto try_shrink(MemoryBlock block, size_t alignment, size_t new_size) const -> bool
+	requires ShrinkableAllocator<A>
+	{
+		return m_allocator->try_shrink(block, alignment, new_size);
+	}
+
+	[[nodiscard]]
+	auto reallocate(MemoryBlock block, size_t alignment, size_t new_size) const -> MemoryBlock
+	requires ReallocatableAllocator<A>
+	{
+		return m_allocator->reallocate(block, alignment, new_size);
+	}
+
+	[[nodiscard]]
+	auto allocate_batch(size_t size, size_t alignment, size_t count, MemoryBlock* blocks) const -> bool
+	requires BatchAllocator<A>
+	{
+		return m_allocator->allocate_batch(size, alignment, count, blocks);
+	}
+
+	void deallocate_batch(const MemoryBlock* blocks, size_t count, size_t alignment) const
+	requires BatchAllocator<A>
+	{
+		m_allocator->deallocate_batch(blocks, count, alignment);
+	}
+
 	/// @}
+
+private:
+	A* m_allocator;
 };
 
 /// @}
 
+/// @name Batch allocation
+/// @{
+
+/// Deallocates `count` blocks.
+///
+/// Calls `allocator.deallocate_batch` if `A` is a `BatchAllocator`, or else deallocates the blocks one at a time.
+template<Allocator A>
+void deallocate_batch(A& allocator, const MemoryBlock* blocks, size_t count, size_t alignment) {
+	if constexpr (BatchAllocator<A>) {
+		allocator.deallocate_batch(blocks, count, alignment);
+	} else {
+		// In reverse order, so that allocators like `Arena` can deallocate a batch allocated one block at a time
+		for (size_t i = count; i > 0; --i) {
+			allocator.deallocate(blocks[i - 1], alignment);
+		}
+	}
+}
+
+/// Allocates `count` blocks of `size` bytes aligned to `alignment` and writes them to `blocks`.
+///
+/// Calls `allocator.allocate_batch` if `A` is a `BatchAllocator`, or else allocates the blocks one at a time.
+///
+/// @returns `false` if the blocks couldn't all be allocated; in that case none is.
+template<Allocator A>
+[[nodiscard]]
+auto allocate_batch(A& allocator, size_t size, size_t alignment, size_t count, MemoryBlock* blocks) -> bool {
+	if constexpr (BatchAllocator<A>) {
+		return allocator.allocate_batch(size, alignment, count, blocks);
+	} else {
+		for (size_t i = 0; i < count; ++i) {
+			blocks[i] = allocator.allocate(size, alignment);
+			if (blocks[i].ptr == nullptr) {
+				bpl::deallocate_batch(allocator, blocks, i, alignment);
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+/// @}
+
+namespace detail {
+
+// The number of nodes that node-based containers allocate or deallocate at a time.
+constexpr size_t node_batch_size = 64;
+
+// Allocates `count` nodes of type `Node` in batches and calls `f(ptr)` on each of them, in order. Sets `node_size` to
+// the size of the allocated blocks.
+//
+// Aborts if memory allocation fails.
+template<typename Node, Allocator A, typename F>
+void allocate_nodes(A& allocator, size_t count, size_t& node_size, F f) {
+	MemoryBlock blocks[node_batch_size];
+	while (count > 0) {
+		const size_t batch = bpl::min(count, node_batch_size);
+		BPL_ASSERT(bpl::allocate_batch(allocator, sizeof(Node), alignof(Node), batch, blocks));
+		node_size = blocks[0].size;
+		for (size_t i = 0; i < batch; ++i) {
+			f(blocks[i].ptr);
+		}
+		count -= batch;
+	}
+}
+
+// Destroys nodes of type `Node` and deallocates them in batches.
+template<typename Node, Allocator A>
+class NodeDeallocator {
+public:
+	NodeDeallocator(A& allocator, size_t node_size) : m_allocator(allocator), m_node_size(node_size) {}
+
+	NodeDeallocator(const NodeDeallocator&) = delete;
+	auto operator=(const NodeDeallocator&) -> NodeDeallocator& = delete;
+
+	~NodeDeallocator() { this->flush(); }
+
+	void push(Node* node) {
+		node->~Node();
+		m_blocks[m_count] = { .ptr = node, .size = m_node_size };
+		m_count += 1;
+		if (m_count == node_batch_size) {
+			this->flush();
+		}
+	}
+
+private:
+	A& m_allocator;
+	size_t m_node_size;
+	MemoryBlock m_blocks[node_batch_size];
+	size_t m_count = 0;
+
+	void flush() {
+		bpl::deallocate_batch(m_allocator, m_blocks, m_count, alignof(Node));
+		m_count = 0;
+	}
+};
+
+} // namespace detail
+
 } // namespace bpl
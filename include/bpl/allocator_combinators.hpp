@@ -0,0 +1,471 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// Allocators built by composing other allocators.
+
+#include <bpl/allocator.hpp>
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ptr.hpp>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bpl {
+
+/// Sends the requests of at most `Threshold` bytes to `Small`, and the others to `Large`.
+///
+/// `Small` may round the size of a block up past `Threshold`. If `Small` is an `OwningAllocator`, each block is
+/// deallocated by the allocator that owns it; otherwise it's deallocated by the allocator that its size selects, so a
+/// block of `Small` larger than `Threshold` is given back to it and a block of `Threshold + 1` bytes is allocated from
+/// `Large` instead. The segregator is growable if both allocators are and `Small` is an `OwningAllocator`, and
+/// shrinkable if both allocators are.
+template<size_t Threshold, Allocator Small, Allocator Large>
+class Segregator {
+public:
+	/// @name Constructors
+	/// @{
+
+	Segregator() = default;
+
+	explicit Segregator(Small&& small, Large&& large) : m_small(std::move(small)), m_large(std::move(large)) {}
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the allocator of the small blocks.
+	auto small() -> Small& { return m_small; }
+
+	/// Returns the allocator of the large blocks.
+	auto large() -> Large& { return m_large; }
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		if (size <= Threshold) {
+			MemoryBlock block = m_small.allocate(size, alignment);
+			if constexpr (!OwningAllocator<Small>) {
+				if (block.size > Threshold) {
+					// The block would be deallocated by `Large`, so `Large` allocates a block larger than the threshold
+					m_small.deallocate(block, alignment);
+					return m_large.allocate(Threshold + 1, alignment);
+				}
+			}
+			return block;
+		}
+		return m_large.allocate(size, alignment);
+	}
+
+	void deallocate(MemoryBlock block, size_t alignment) {
+		if (this->is_small(block)) {
+			m_small.deallocate(block, alignment);
+		} else {
+			m_large.deallocate(block, alignment);
+		}
+	}
+
+	/// Grows `block` in-place if it stays on the same side of the threshold.
+	[[nodiscard]]
+	auto try_grow(MemoryBlock block, size_t alignment, size_t additional) -> MemoryBlock
+	requires GrowableAllocator<Small> && GrowableAllocator<Large> && OwningAllocator<Small>
+	{
+		if (!m_small.owns(block)) {
+			return m_large.try_grow(block, alignment, additional);
+		}
+		if (block.size > Threshold || additional > Threshold - block.size) {
+			return {};
+		}
+		return m_small.try_grow(block, alignment, additional);
+	}
+
+	/// Shrinks `block` in-place if it stays on the same side of the threshold.
+	[[nodiscard]]
+	auto try_shrink(MemoryBlock block, size_t alignment, size_t new_size) -> bool
+	requires ShrinkableAllocator<Small> && ShrinkableAllocator<Large>
+	{
+		if (this->is_small(block)) {
+			return m_small.try_shrink(block, alignment, new_size);
+		}
+		if (new_size <= Threshold) {
+			return false;
+		}
+		return m_large.try_shrink(block, alignment, new_size);
+	}
+
+	/// @}
+
+private:
+	[[no_unique_address]] Small m_small{};
+	[[no_unique_address]] Large m_large{};
+
+	// Returns whether `block` was allocated by `Small`.
+	auto is_small(MemoryBlock block) const -> bool {
+		if constexpr (OwningAllocator<Small>) {
+			return m_small.owns(block);
+		} else {
+			return block.size <= Threshold;
+		}
+	}
+};
+
+/// Allocates from `Primary`, and from `Secondary` when `Primary` fails.
+///
+/// `Primary` must tell which blocks it owns, to deallocate each block with the allocator that allocated it. The
+/// fallback allocator is growable or shrinkable if both allocators are.
+template<OwningAllocator Primary, Allocator Secondary>
+class FallbackAllocator {
+public:
+	/// @name Constructors
+	/// @{
+
+	FallbackAllocator() = default;
+
+	explicit FallbackAllocator(Primary&& primary, Secondary&& secondary)
+		: m_primary(std::move(primary)),
+		  m_secondary(std::move(secondary)) {}
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the allocator that is tried first.
+	auto primary() -> Primary& { return m_primary; }
+
+	/// Returns the allocator that is used when the primary allocator fails.
+	auto secondary() -> Secondary& { return m_secondary; }
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		MemoryBlock block = m_primary.allocate(size, alignment);
+		if (block.ptr == nullptr) {
+			return m_secondary.allocate(size, alignment);
+		}
+		return block;
+	}
+
+	void deallocate(MemoryBlock block, size_t alignment) {
+		if (m_primary.owns(block)) {
+			m_primary.deallocate(block, alignment);
+		} else {
+			m_secondary.deallocate(block, alignment);
+		}
+	}
+
+	[[nodiscard]]
+	auto try_grow(MemoryBlock block, size_t alignment, size_t additional) -> MemoryBlock
+	requires GrowableAllocator<Primary> && GrowableAllocator<Secondary>
+	{
+		if (m_primary.owns(block)) {
+			return m_primary.try_grow(block, alignment, additional);
+		}
+		return m_secondary.try_grow(block, alignment, additional);
+	}
+
+	[[nodiscard]]
+	auto try_shrink(MemoryBlock block, size_t alignment, size_t new_size) -> bool
+	requires ShrinkableAllocator<Primary> && ShrinkableAllocator<Secondary>
+	{
+		if (m_primary.owns(block)) {
+			return m_primary.try_shrink(block, alignment, new_size);
+		}
+		return m_secondary.try_shrink(block, alignment, new_size);
+	}
+
+	/// @}
+
+private:
+	[[no_unique_address]] Primary m_primary{};
+	[[no_unique_address]] Secondary m_secondary{};
+};
+
+namespace detail {
+
+// The number of bytes taken by an affix, `0` for `void`.
+template<typename T>
+inline constexpr size_t affix_size = sizeof(T);
+template<>
+inline constexpr size_t affix_size<void> = 0;
+
+// The alignment of an affix, `1` for `void`.
+template<typename T>
+inline constexpr size_t affix_alignment = alignof(T);
+template<>
+inline constexpr size_t affix_alignment<void> = 1;
+
+} // namespace detail
+
+/// Stores a `Prefix` before and a `Suffix` after each block allocated from `A`, for example to add headers or guards.
+///
+/// The affixes are value-initialized when a block is allocated, and destroyed when it's deallocated. Either of them
+/// can be `void`. The affix allocator is growable or shrinkable if `A` is.
+template<Allocator A, typename Prefix, typename Suffix = void>
+class AffixAllocator {
+public:
+	/// @name Constructors
+	/// @{
+
+	AffixAllocator() = default;
+
+	explicit AffixAllocator(A&& allocator) : m_allocator(std::move(allocator)) {}
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the underlying allocator.
+	auto allocator() -> A& { return m_allocator; }
+
+	/// Returns the prefix of `block`.
+	static auto prefix(MemoryBlock block) -> std::add_lvalue_reference_t<Prefix>
+	requires (!std::is_void_v<Prefix>)
+	{
+		return *static_cast<Prefix*>(static_cast<void*>(static_cast<std::byte*>(block.ptr) - sizeof(Prefix)));
+	}
+
+	/// Returns the suffix of `block`.
+	static auto suffix(MemoryBlock block) -> std::add_lvalue_reference_t<Suffix>
+	requires (!std::is_void_v<Suffix>)
+	{
+		return *static_cast<Suffix*>(static_cast<void*>(static_cast<std::byte*>(block.ptr) + block.size));
+	}
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		const size_t offset = AffixAllocator::prefix_offset(alignment);
+		MemoryBlock inner = m_allocator.allocate(
+			offset + align_forward(size, suffix_alignment) + suffix_size, AffixAllocator::inner_alignment(alignment)
+		);
+		if (inner.ptr == nullptr) {
+			return {};
+		}
+		BPL_DEBUG_ASSERT(inner.size % suffix_alignment == 0);
+		MemoryBlock block = {
+			.ptr = static_cast<std::byte*>(inner.ptr) + offset,
+			.size = inner.size - offset - suffix_size,
+		};
+		if constexpr (!std::is_void_v<Prefix>) {
+			std::construct_at(std::addressof(prefix(block)));
+		}
+		if constexpr (!std::is_void_v<Suffix>) {
+			std::construct_at(std::addressof(suffix(block)));
+		}
+		return block;
+	}
+
+	void deallocate(MemoryBlock block, size_t alignment) {
+		if constexpr (!std::is_void_v<Suffix>) {
+			std::destroy_at(std::addressof(suffix(block)));
+		}
+		if constexpr (!std::is_void_v<Prefix>) {
+			std::destroy_at(std::addressof(prefix(block)));
+		}
+		m_allocator.deallocate(
+			AffixAllocator::inner_block(block, alignment), AffixAllocator::inner_alignment(alignment)
+		);
+	}
+
+	/// Grows `block` in-place, moving its suffix to the new end.
+	[[nodiscard]]
+	auto try_grow(MemoryBlock block, size_t alignment, size_t additional) -> MemoryBlock
+	requires GrowableAllocator<A>
+	{
+		MemoryBlock inner = m_allocator.try_grow(
+			AffixAllocator::inner_block(block, alignment),
+			AffixAllocator::inner_alignment(alignment),
+			align_forward(additional, suffix_alignment)
+		);
+		if (inner.ptr == nullptr) {
+			return {};
+		}
+		BPL_DEBUG_ASSERT(inner.size % suffix_alignment == 0);
+		MemoryBlock new_block = {
+			.ptr = block.ptr,
+			.size = inner.size - AffixAllocator::prefix_offset(alignment) - suffix_size,
+		};
+		AffixAllocator::move_suffix(block, new_block);
+		return new_block;
+	}
+
+	/// Shrinks `block` in-place, moving its suffix to the new end.
+	[[nodiscard]]
+	auto try_shrink(MemoryBlock block, size_t alignment, size_t new_size) -> bool
+	requires ShrinkableAllocator<A>
+	{
+		// The suffix must stay aligned
+		if (new_size > block.size || new_size % suffix_alignment != 0) {
+			return false;
+		}
+		MemoryBlock new_block = { .ptr = block.ptr, .size = new_size };
+		// The suffix moves before the block shrinks, because it may end up out of the shrunk block
+		AffixAllocator::move_suffix(block, new_block);
+		const size_t offset = AffixAllocator::prefix_offset(alignment);
+		if (!m_allocator.try_shrink(
+				AffixAllocator::inner_block(block, alignment),
+				AffixAllocator::inner_alignment(alignment),
+				offset + new_size + suffix_size
+			)) {
+			AffixAllocator::move_suffix(new_block, block);
+			return false;
+		}
+		return true;
+	}
+
+	/// @}
+
+private:
+	static constexpr size_t prefix_size = detail::affix_size<Prefix>;
+	static constexpr size_t suffix_size = detail::affix_size<Suffix>;
+	static constexpr size_t suffix_alignment = detail::affix_alignment<Suffix>;
+
+	[[no_unique_address]] A m_allocator{};
+
+	static constexpr auto inner_alignment(size_t alignment) -> size_t {
+		return bpl::max(bpl::max(alignment, detail::affix_alignment<Prefix>), suffix_alignment);
+	}
+
+	// The distance between the beginning of the inner block and the beginning of the block, which keeps the block
+	// aligned to `alignment` and the prefix right before it.
+	static constexpr auto prefix_offset(size_t alignment) -> size_t {
+		return align_forward(prefix_size, AffixAllocator::inner_alignment(alignment));
+	}
+
+	static auto inner_block(MemoryBlock block, size_t alignment) -> MemoryBlock {
+		const size_t offset = AffixAllocator::prefix_offset(alignment);
+		return { .ptr = static_cast<std::byte*>(block.ptr) - offset, .size = offset + block.size + suffix_size };
+	}
+
+	static void move_suffix(MemoryBlock from, MemoryBlock to) {
+		if constexpr (!std::is_void_v<Suffix>) {
+			Suffix value = std::move(suffix(from));
+			std::destroy_at(std::addressof(suffix(from)));
+			std::construct_at(std::addressof(suffix(to)), std::move(value));
+		}
+	}
+};
+
+/// Counters of an allocator, updated by `StatsAllocator`.
+struct AllocatorStats {
+	/// The number of successful calls to `allocate`.
+	size_t allocations = 0;
+	/// The number of calls to `deallocate`.
+	size_t deallocations = 0;
+	/// The number of successful calls to `try_grow` and `try_shrink`.
+	size_t resizes = 0;
+	/// The number of bytes currently allocated.
+	size_t bytes = 0;
+	/// The highest number of bytes allocated at the same time.
+	size_t peak_bytes = 0;
+	/// The number of bytes allocated since the beginning, without subtracting the deallocated ones.
+	size_t total_bytes = 0;
+};
+
+/// Forwards every call to `A`, counting calls and bytes.
+///
+/// The stats allocator is growable or shrinkable if `A` is.
+template<Allocator A>
+class StatsAllocator {
+public:
+	/// @name Constructors
+	/// @{
+
+	StatsAllocator() = default;
+
+	explicit StatsAllocator(A&& allocator) : m_allocator(std::move(allocator)) {}
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the underlying allocator.
+	auto allocator() -> A& { return m_allocator; }
+
+	/// Returns the counters.
+	auto stats() const -> const AllocatorStats& { return m_stats; }
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		MemoryBlock block = m_allocator.allocate(size, alignment);
+		if (block.ptr != nullptr) {
+			m_stats.allocations += 1;
+			this->add_bytes(block.size);
+		}
+		return block;
+	}
+
+	void deallocate(MemoryBlock block, size_t alignment) {
+		m_allocator.deallocate(block, alignment);
+		m_stats.deallocations += 1;
+		m_stats.bytes -= block.size;
+	}
+
+	[[nodiscard]]
+	auto try_grow(MemoryBlock block, size_t alignment, size_t additional) -> MemoryBlock
+	requires GrowableAllocator<A>
+	{
+		MemoryBlock new_block = m_allocator.try_grow(block, alignment, additional);
+		if (new_block.ptr != nullptr) {
+			m_stats.resizes += 1;
+			this->add_bytes(new_block.size - block.size);
+		}
+		return new_block;
+	}
+
+	[[nodiscard]]
+	auto try_shrink(MemoryBlock block, size_t alignment, size_t new_size) -> bool
+	requires ShrinkableAllocator<A>
+	{
+		if (!m_allocator.try_shrink(block, alignment, new_size)) {
+			return false;
+		}
+		m_stats.resizes += 1;
+		m_stats.bytes -= block.size - new_size;
+		return true;
+	}
+
+	/// @}
+
+private:
+	[[no_unique_address]] A m_allocator{};
+	AllocatorStats m_stats;
+
+	void add_bytes(size_t bytes) {
+		m_stats.bytes += bytes;
+		m_stats.total_bytes += bytes;
+		m_stats.peak_bytes = bpl::max(m_stats.peak_bytes, m_stats.bytes);
+	}
+};
+
+} // namespace bpl
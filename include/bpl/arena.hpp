@@ -3,12 +3,17 @@
 
 #pragma once
 
+#include <bpl/allocator.hpp>
 #include <bpl/assert.hpp>
 #include <bpl/bit.hpp>
+#include <bpl/literals.hpp>
+#include <bpl/math.hpp>
 #include <bpl/memory.hpp>
 #include <bpl/os.hpp>
 #include <bpl/ptr.hpp>
 
+#include <limits>
+#include <new>
 #include <utility>
 
 #include <cstddef>
@@ -16,6 +21,64 @@
 
 namespace bpl {
 
+/// Options to create an arena.
+struct ArenaOptions {
+	/// The size of the first region of memory, in bytes.
+	size_t capacity = 0;
+	/// If `true`, when a region is full the arena reserves a new region, twice as big as the previous one, instead of
+	/// failing to allocate.
+	bool chained = false;
+	/// The number of bytes committed at a time as the arena grows, rounded up to a multiple of the page size.
+	///
+	/// If `0`, each region is entirely committed when it's reserved.
+	size_t commit_step = 0;
+	/// The number of bytes that `clear()` keeps committed, see `Arena::decommit_above`.
+	///
+	/// By default, `clear()` doesn't decommit any memory.
+	size_t high_water = std::numeric_limits<size_t>::max();
+	/// If `true`, the pages are populated with `prefault_memory` as soon as they're committed, so that the first
+	/// allocations don't take page faults.
+	bool prefault = false;
+	/// The NUMA policy of the memory reserved by the arena, for example to place it on the node of the threads that
+	/// will use it rather than on the node of the thread that creates the arena.
+	NumaPolicy numa = {};
+};
+
+namespace detail {
+
+// Header at the beginning of each region of a chained arena.
+struct ArenaRegion {
+	// The whole region, including this header
+	MemoryBlock block;
+	// The next region, which is kept after the arena is cleared
+	ArenaRegion* next;
+	// The end of the committed pages of the region, only up to date when the region isn't the current one
+	void* committed_end;
+};
+
+// Size of the header at the beginning of each region of a chained arena.
+inline constexpr size_t arena_region_header_size = align_forward(sizeof(ArenaRegion), alignof(std::max_align_t));
+
+} // namespace detail
+
+/// A position in an arena, returned by `Arena::mark()` and only meaningful to `Arena::rewind()`.
+class ArenaMark {
+private:
+	friend class Arena;
+
+	// The current region when the mark was taken, `nullptr` if the arena isn't chained
+	detail::ArenaRegion* m_region = nullptr;
+	// The end of the last allocation when the mark was taken
+	void* m_end = nullptr;
+	// The number of bytes allocated in the regions before `m_region`
+	size_t m_previous_size = 0;
+
+	ArenaMark(detail::ArenaRegion* region, void* end, size_t previous_size)
+		: m_region(region),
+		  m_end(end),
+		  m_previous_size(previous_size) {}
+};
+
 /// An arena allocator.
 class Arena {
 public:
@@ -32,17 +95,33 @@ public:
 
 	Arena(Arena&& other) noexcept
 		: m_block(std::exchange(other.m_block, {})),
-		  m_end(std::exchange(other.m_end, nullptr)) {}
+		  m_end(std::exchange(other.m_end, nullptr)),
+		  m_first(std::exchange(other.m_first, nullptr)),
+		  m_region(std::exchange(other.m_region, nullptr)),
+		  m_previous_size(std::exchange(other.m_previous_size, 0)),
+		  m_committed_end(std::exchange(other.m_committed_end, nullptr)),
+		  m_commit_step(std::exchange(other.m_commit_step, 0)),
+		  m_high_water(std::exchange(other.m_high_water, std::numeric_limits<size_t>::max())),
+		  m_prefault(std::exchange(other.m_prefault, false)),
+		  m_numa(std::exchange(other.m_numa, {})) {}
 	auto operator=(Arena&& other) noexcept -> Arena& {
-		m_block = std::exchange(other.m_block, {});
-		m_end = std::exchange(other.m_end, {});
+		if (this != &other) {
+			this->release();
+			m_block = std::exchange(other.m_block, {});
+			m_end = std::exchange(other.m_end, {});
+			m_first = std::exchange(other.m_first, nullptr);
+			m_region = std::exchange(other.m_region, nullptr);
+			m_previous_size = std::exchange(other.m_previous_size, 0);
+			m_committed_end = std::exchange(other.m_committed_end, nullptr);
+			m_commit_step = std::exchange(other.m_commit_step, 0);
+			m_high_water = std::exchange(other.m_high_water, std::numeric_limits<size_t>::max());
+			m_prefault = std::exchange(other.m_prefault, false);
+			m_numa = std::exchange(other.m_numa, {});
+		}
 		return *this;
 	}
 
-	~Arena() {
-		(void) try_decommit_memory(m_block);
-		(void) try_release_memory(m_block);
-	}
+	~Arena() { this->release(); }
 
 	/// @}
 
@@ -56,11 +135,32 @@ public:
 	///
 	/// @pre
 	///   - `capacity > 0`
-	explicit Arena(size_t capacity) {
-		BPL_ASSERT(capacity > 0);
-		m_block = reserve_memory(capacity);
-		BPL_ASSERT(try_commit_memory(m_block));
-		m_end = m_block.ptr;
+	explicit Arena(size_t capacity) : Arena(ArenaOptions{ .capacity = capacity }) {}
+
+	/// Creates an arena as described by `options`.
+	///
+	/// Aborts if memory allocation fails.
+	///
+	/// @pre
+	///   - `options.capacity > 0`
+	explicit Arena(ArenaOptions options)
+		: m_commit_step(options.commit_step == 0 ? 0 : align_forward(options.commit_step, get_page_size())),
+		  m_high_water(options.high_water),
+		  m_prefault(options.prefault),
+		  m_numa(options.numa) {
+		BPL_ASSERT(options.capacity > 0);
+		if (options.chained) {
+			m_first = this->make_region(options.capacity + detail::arena_region_header_size);
+			this->enter_region(m_first);
+			m_previous_size = 0;
+		} else {
+			m_block = reserve_memory(options.capacity, HugePages::none, m_numa);
+			m_end = m_block.ptr;
+			m_committed_end = m_block.ptr;
+			if (m_commit_step == 0) {
+				BPL_ASSERT(this->try_commit_until(ptr_to_addr(m_block.ptr) + m_block.size));
+			}
+		}
 	}
 
 	/// @}
@@ -69,14 +169,37 @@ public:
 	/// @name Inspection
 	/// @{
 
+	/// Returns the number of bytes that can be allocated without reserving more memory.
 	[[nodiscard]]
 	auto capacity() const -> size_t {
-		return m_block.size;
+		if (m_first == nullptr) {
+			return m_block.size;
+		}
+		size_t capacity = 0;
+		for (const detail::ArenaRegion* region = m_first; region != nullptr; region = region->next) {
+			capacity += region->block.size - detail::arena_region_header_size;
+		}
+		return capacity;
+	}
+
+	/// Returns the number of bytes of committed memory, including the headers of the regions.
+	[[nodiscard]]
+	auto committed() const -> size_t {
+		if (m_first == nullptr) {
+			return ptr_to_addr(m_committed_end) - ptr_to_addr(m_block.ptr);
+		}
+		size_t committed = 0;
+		for (const detail::ArenaRegion* region = m_first; region != nullptr; region = region->next) {
+			const void* committed_end = region == m_region ? m_committed_end : region->committed_end;
+			committed += ptr_to_addr(committed_end) - ptr_to_addr(region->block.ptr);
+		}
+		return committed;
 	}
 
+	/// Returns the number of bytes allocated, including padding.
 	[[nodiscard]]
 	auto size() const -> size_t {
-		return ptr_to_addr(m_end) - ptr_to_addr(m_block.ptr);
+		return m_previous_size + (ptr_to_addr(m_end) - ptr_to_addr(m_block.ptr));
 	}
 
 	[[nodiscard]]
@@ -84,39 +207,134 @@ public:
 		return this->size() == 0;
 	}
 
+	/// Returns `true` if `block` lies in the memory reserved by the arena.
+	[[nodiscard]]
+	auto owns(MemoryBlock block) const -> bool {
+		const auto* ptr = static_cast<const std::byte*>(block.ptr);
+		if (m_first == nullptr) {
+			const auto* begin = static_cast<const std::byte*>(m_block.ptr);
+			return pointer_in_range(begin, ptr, begin + m_block.size);
+		}
+		for (const detail::ArenaRegion* region = m_first; region != nullptr; region = region->next) {
+			const auto* begin = static_cast<const std::byte*>(region->block.ptr);
+			if (pointer_in_range(begin, ptr, begin + region->block.size)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// Returns `true` if the arena reserves new regions when it's full.
+	[[nodiscard]]
+	auto chained() const -> bool {
+		return m_first != nullptr;
+	}
+
 	/// @}
 
 	//////////////////////////////////////////////////
 	/// @name Methods
 	/// @{
 
+	/// Allocates `size` bytes aligned to `alignment`.
+	///
+	/// If the arena is chained and the current region is full, the allocation continues in the next region.
+	///
+	/// @returns The allocated block, or an empty block if the arena is full.
 	[[nodiscard]]
 	auto push(size_t size, size_t alignment) -> MemoryBlock {
-		uintptr_t addr_begin = align_forward(ptr_to_addr(m_end), alignment);
-		uintptr_t addr_end = align_forward(addr_begin + size, alignment);
-		if (addr_end > ptr_to_addr(m_block.ptr) + m_block.size) {
-			return {};
+		MemoryBlock block = this->push_in_region(size, alignment);
+		if (block.ptr == nullptr && this->chained()) {
+			return this->push_in_next_region(size, alignment);
 		}
-		m_end = addr_to_ptr<void>(addr_end);
-		return {
-			.ptr = addr_to_ptr<void>(addr_begin),
-			.size = static_cast<size_t>(addr_end - addr_begin),
-		};
+		return block;
 	}
 
+	/// Deallocates `block` if it's the last block allocated in the current region.
+	///
+	/// @returns `true` if the block was deallocated.
 	[[nodiscard]]
 	auto pop(MemoryBlock block, size_t alignment) -> bool {
 		uintptr_t block_end = ptr_to_addr(block.ptr) + block.size;
 		uintptr_t arena_end_aligned = align_forward(ptr_to_addr(m_end), alignment);
-		if (block_end != arena_end_aligned) {
+		if (block_end != arena_end_aligned || ptr_to_addr(block.ptr) < ptr_to_addr(m_block.ptr)) {
 			return false;
 		}
 		m_end = block.ptr;
 		return true;
 	}
 
+	/// Returns the current position of the arena, to deallocate everything allocated after it with `rewind`.
+	[[nodiscard]]
+	auto mark() const -> ArenaMark {
+		return ArenaMark(m_region, m_end, m_previous_size);
+	}
+
+	/// Deallocates everything allocated after `mark` was taken.
+	///
+	/// A chained arena goes back to the region of the mark, and keeps the regions after it to reuse them.
+	///
+	/// @pre
+	///   - `mark` was returned by `mark()` on this arena, and the arena wasn't cleared or rewound before it since.
+	void rewind(ArenaMark mark) {
+		BPL_DEBUG_ASSERT(mark.m_previous_size <= m_previous_size);
+		if (mark.m_region != m_region) {
+			this->enter_region(mark.m_region);
+		}
+		BPL_DEBUG_ASSERT(ptr_to_addr(mark.m_end) >= ptr_to_addr(m_block.ptr));
+		BPL_DEBUG_ASSERT(ptr_to_addr(mark.m_end) <= this->region_end());
+		m_end = mark.m_end;
+		m_previous_size = mark.m_previous_size;
+	}
+
 	/// Clears the arena.
-	void clear() { m_end = m_block.ptr; }
+	///
+	/// A chained arena goes back to its first region, and keeps the other regions to reuse them. If the arena was
+	/// created with a `high_water`, the memory above it is decommitted.
+	void clear() {
+		if (this->chained()) {
+			this->enter_region(m_first);
+			m_previous_size = 0;
+		} else {
+			m_end = m_block.ptr;
+		}
+		if (m_high_water != std::numeric_limits<size_t>::max()) {
+			this->decommit_above(m_high_water);
+		}
+	}
+
+	/// Gives the memory of the arena back to the OS, except for the first `high_water` bytes of the current region and
+	/// the memory that is allocated in it.
+	///
+	/// The regions after the current one of a chained arena are entirely decommitted, but stay reserved to be reused.
+	/// The decommitted pages are committed again when the arena grows.
+	void decommit_above(size_t high_water) {
+		const uintptr_t region_end = this->region_end();
+		const uintptr_t used_end = bpl::max(
+			ptr_to_addr(m_end), ptr_to_addr(m_block.ptr) + bpl::min(high_water, m_block.size)
+		);
+		const uintptr_t keep_end = bpl::min(align_forward(used_end, get_page_size()), region_end);
+		if (keep_end < ptr_to_addr(m_committed_end)) {
+			BPL_ASSERT(try_decommit_memory(
+				{ .ptr = addr_to_ptr<void>(keep_end), .size = ptr_to_addr(m_committed_end) - keep_end }
+			));
+			m_committed_end = addr_to_ptr<void>(keep_end);
+		}
+		if (!this->chained()) {
+			return;
+		}
+		for (detail::ArenaRegion* region = m_region->next; region != nullptr; region = region->next) {
+			// The header stays committed
+			const uintptr_t header_end =
+				align_forward(ptr_to_addr(region->block.ptr) + detail::arena_region_header_size, get_page_size());
+			if (header_end < ptr_to_addr(region->committed_end)) {
+				BPL_ASSERT(try_decommit_memory(
+					{ .ptr = addr_to_ptr<void>(header_end), .size = ptr_to_addr(region->committed_end) - header_end }
+				));
+				region->committed_end = addr_to_ptr<void>(header_end);
+			}
+		}
+	}
 
 	/// @}
 
@@ -137,7 +355,12 @@ public:
 		if (block_end != arena_end) {
 			return {};
 		}
-		MemoryBlock new_block = this->push(additional, alignment);
+		// The block can only grow within the current region
+		MemoryBlock new_block = this->push_in_region(additional, alignment);
+		if (new_block.ptr == nullptr) {
+			return {};
+		}
+		BPL_DEBUG_ASSERT(ptr_to_addr(new_block.ptr) == block_end);
 		return { .ptr = block.ptr, .size = block.size + new_block.size };
 	}
 
@@ -151,11 +374,243 @@ public:
 		);
 	}
 
+	/// Allocates `count` contiguous blocks with a single push, so the arena checks its capacity once.
+	[[nodiscard]]
+	auto allocate_batch(size_t size, size_t alignment, size_t count, MemoryBlock* blocks) -> bool {
+		const size_t stride = align_forward(size, alignment);
+		if (count == 0) {
+			return true;
+		}
+		if (stride != 0 && count > std::numeric_limits<size_t>::max() / stride) {
+			return false;
+		}
+		MemoryBlock block = this->push(stride * count, alignment);
+		if (block.ptr == nullptr) {
+			return false;
+		}
+		for (size_t i = 0; i < count; ++i) {
+			blocks[i] = { .ptr = static_cast<char*>(block.ptr) + (i * stride), .size = stride };
+		}
+		return true;
+	}
+
+	/// Deallocates the blocks in reverse order, so that a batch that is the last allocation of the current region is
+	/// deallocated entirely.
+	void deallocate_batch(const MemoryBlock* blocks, size_t count, size_t alignment) {
+		for (size_t i = count; i > 0; --i) {
+			this->deallocate(blocks[i - 1], alignment);
+		}
+	}
+
 	/// @}
 
 private:
+	// The usable part of the current region
 	MemoryBlock m_block = {};
+	// The end of the last allocation in the current region
 	void* m_end = m_block.ptr;
+	// The first region of a chained arena, `nullptr` if the arena isn't chained
+	detail::ArenaRegion* m_first = nullptr;
+	// The current region of a chained arena
+	detail::ArenaRegion* m_region = nullptr;
+	// The number of bytes allocated in the regions before the current one
+	size_t m_previous_size = 0;
+	// The end of the committed pages of the current region
+	void* m_committed_end = nullptr;
+	// The number of bytes committed at a time, `0` to commit whole regions
+	size_t m_commit_step = 0;
+	// The number of bytes kept committed by `clear()`
+	size_t m_high_water = std::numeric_limits<size_t>::max();
+	// Whether the pages are prefaulted when they're committed
+	bool m_prefault = false;
+	// The NUMA policy of the regions
+	NumaPolicy m_numa = {};
+
+	// Returns the end of the current region.
+	[[nodiscard]]
+	auto region_end() const -> uintptr_t {
+		return ptr_to_addr(m_block.ptr) + m_block.size;
+	}
+
+	// Commits the pages of the current region up to at least `addr`, one step at a time.
+	[[nodiscard]]
+	auto try_commit_until(uintptr_t addr) -> bool {
+		const uintptr_t committed_end = ptr_to_addr(m_committed_end);
+		if (addr <= committed_end) {
+			return true;
+		}
+		uintptr_t new_committed_end = this->region_end();
+		if (m_commit_step != 0) {
+			const size_t steps = (addr - committed_end + m_commit_step - 1) / m_commit_step;
+			new_committed_end = bpl::min(committed_end + (steps * m_commit_step), new_committed_end);
+		}
+		const MemoryBlock pages = { .ptr = m_committed_end, .size = new_committed_end - committed_end };
+		if (!try_commit_memory(pages)) {
+			return false;
+		}
+		if (m_prefault) {
+			prefault_memory(pages);
+		}
+		m_committed_end = addr_to_ptr<void>(new_committed_end);
+		return true;
+	}
+
+	[[nodiscard]]
+	auto push_in_region(size_t size, size_t alignment) -> MemoryBlock {
+		uintptr_t addr_begin = align_forward(ptr_to_addr(m_end), alignment);
+		uintptr_t addr_end = align_forward(addr_begin + size, alignment);
+		if (addr_end > this->region_end() || !this->try_commit_until(addr_end)) {
+			return {};
+		}
+		m_end = addr_to_ptr<void>(addr_end);
+		return {
+			.ptr = addr_to_ptr<void>(addr_begin),
+			.size = static_cast<size_t>(addr_end - addr_begin),
+		};
+	}
+
+	// Moves to the first region after the current one that can fit the allocation, reserving a new one if needed.
+	[[nodiscard]]
+	auto push_in_next_region(size_t size, size_t alignment) -> MemoryBlock {
+		// Enough for `size` bytes and the padding needed to align them
+		const size_t required = detail::arena_region_header_size + align_forward(size, alignment) + alignment;
+		detail::ArenaRegion* next = m_region->next;
+		while (next != nullptr && next->block.size < required) {
+			next = next->next;
+		}
+		if (next == nullptr) {
+			next = this->make_region(bpl::max(m_region->block.size * 2, required));
+			next->next = m_region->next;
+			m_region->next = next;
+		}
+		m_previous_size += ptr_to_addr(m_end) - ptr_to_addr(m_block.ptr);
+		this->enter_region(next);
+		MemoryBlock block = this->push_in_region(size, alignment);
+		BPL_DEBUG_ASSERT(block.ptr != nullptr);
+		return block;
+	}
+
+	void enter_region(detail::ArenaRegion* region) {
+		if (m_region != nullptr) {
+			m_region->committed_end = m_committed_end;
+		}
+		m_region = region;
+		m_committed_end = region->committed_end;
+		m_block = {
+			.ptr = static_cast<char*>(region->block.ptr) + detail::arena_region_header_size,
+			.size = region->block.size - detail::arena_region_header_size,
+		};
+		m_end = m_block.ptr;
+	}
+
+	// Reserves a region of at least `size` bytes, including its header, and commits its first step.
+	auto make_region(size_t size) const -> detail::ArenaRegion* {
+		MemoryBlock block = reserve_memory(size, HugePages::none, m_numa);
+		const size_t committed = m_commit_step == 0 ? block.size : bpl::min(m_commit_step, block.size);
+		BPL_ASSERT(try_commit_memory({ .ptr = block.ptr, .size = committed }));
+		if (m_prefault) {
+			prefault_memory({ .ptr = block.ptr, .size = committed });
+		}
+		return ::new (block.ptr) detail::ArenaRegion{
+			.block = block,
+			.next = nullptr,
+			.committed_end = static_cast<char*>(block.ptr) + committed,
+		};
+	}
+
+	// Releases all the memory reserved by the arena.
+	void release() {
+		if (this->chained()) {
+			detail::ArenaRegion* region = m_first;
+			while (region != nullptr) {
+				MemoryBlock block = region->block;
+				region = region->next;
+				(void) try_decommit_memory(block);
+				(void) try_release_memory(block);
+			}
+			m_first = nullptr;
+			m_region = nullptr;
+		} else if (m_block.ptr != nullptr) {
+			(void) try_decommit_memory(m_block);
+			(void) try_release_memory(m_block);
+		}
+		m_block = {};
+		m_end = nullptr;
+		m_previous_size = 0;
+		m_committed_end = nullptr;
+	}
 };
 
+/// A non-owning handle to an arena, so that many containers can allocate from it and be freed at once by `clear()`.
+using ArenaRef = AllocatorRef<Arena>;
+
+/// Rewinds an arena to where it was when the scope was created, when the scope is destroyed.
+class ScratchScope {
+public:
+	/// @name Special member functions
+	/// @{
+
+	ScratchScope(const ScratchScope&) = delete;
+	auto operator=(const ScratchScope&) -> ScratchScope& = delete;
+
+	~ScratchScope() { m_arena->rewind(m_mark); }
+
+	/// @}
+
+	/// @name Constructors
+	/// @{
+
+	/// Marks the current position of `arena`.
+	explicit ScratchScope(Arena& arena) : m_arena(&arena), m_mark(arena.mark()) {}
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the arena, to allocate memory that is deallocated at the end of the scope.
+	[[nodiscard]]
+	auto arena() const -> Arena& {
+		return *m_arena;
+	}
+
+	/// @}
+
+private:
+	Arena* m_arena;
+	ArenaMark m_mark;
+};
+
+namespace detail {
+
+// The scratch arenas of the calling thread.
+inline auto scratch_arenas() -> Arena (&)[2] {
+	static constexpr ArenaOptions options = {
+		.capacity = 1_MiB,
+		.chained = true,
+		.commit_step = 64_KiB,
+	};
+	thread_local Arena arenas[2] = { Arena(options), Arena(options) };
+	return arenas;
+}
+
+} // namespace detail
+
+/// Returns a scope on one of the scratch arenas of the calling thread, which is not `conflict`.
+///
+/// Each thread has two scratch arenas, reserved on first use. A function that receives an arena to allocate its result
+/// passes it as `conflict`, so that its temporary allocations don't end up in the middle of the result.
+///
+/// ```cpp
+/// auto f(Arena& result) -> Span<int> {
+///     ScratchScope scratch = get_scratch_arena(&result);
+///     // Allocate temporaries from `scratch.arena()`, and the result from `result`
+/// }
+/// ```
+[[nodiscard]]
+inline auto get_scratch_arena(const Arena* conflict = nullptr) -> ScratchScope {
+	Arena(&arenas)[2] = detail::scratch_arenas();
+	return ScratchScope(&arenas[0] == conflict ? arenas[1] : arenas[0]);
+}
+
 } // namespace bpl
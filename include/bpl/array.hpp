@@ -5,6 +5,7 @@
 
 #include <bpl/allocator.hpp>
 #include <bpl/assert.hpp>
+#include <bpl/growth.hpp>
 #include <bpl/math.hpp>
 #include <bpl/memory.hpp>
 #include <bpl/ranges.hpp>
@@ -21,7 +22,9 @@
 namespace bpl {
 
 /// A dynamic array.
-template<relocatable T, Allocator A = GlobalAllocator>
+///
+/// @tparam G Computes the new capacity when elements are added to a full array.
+template<relocatable T, Allocator A = GlobalAllocator, GrowthPolicy G = DoublingGrowth>
 class Array {
 public:
 	/// @name Special member functions
@@ -161,8 +164,18 @@ public:
 	/// @{
 
 	/// Increases capacity of the container to fit at least `count` elements.
+	///
+	/// If the allocator is a `GrowableAllocator`, the current block is extended in-place when possible. If the allocator
+	/// is a `ReallocatableAllocator` and `T` is trivially relocatable, the block is reallocated without copying when
+	/// possible.
 	void reserve(size_t count);
 
+	/// Reduces the capacity of the container to fit its elements.
+	///
+	/// If the allocator is a `ShrinkableAllocator`, the current block is shrunk in-place when possible, otherwise it's
+	/// left untouched; with any other allocator the elements are relocated to a smaller block.
+	void shrink_to_fit();
+
 	/// Destroys all elements in the array.
 	void clear();
 
@@ -196,6 +209,24 @@ public:
 	template<contiguous_range R>
 	void append_range(R&& range);
 
+	/// Reserves space for `n` more elements and returns it, without changing the size of the array.
+	///
+	/// The elements in the returned span are uninitialized: write to them (constructing them, if `T` isn't trivial) and
+	/// then call `commit` with the number of elements that were written, e.g., the return value of `read(2)`.
+	///
+	/// @warning The span is invalidated by any operation that changes the capacity.
+	///
+	/// @returns A span of `n` uninitialized elements just after the last element.
+	[[nodiscard]]
+	auto append_uninit(size_t n) -> Span<T>;
+
+	/// Appends the first `n` elements of the span returned by `append_uninit`, after they have been initialized.
+	///
+	/// @pre
+	///   - `n <= capacity() - size()`
+	///   - The first `n` elements after the last element have been initialized.
+	void commit(size_t n);
+
 	/// Inserts an element before `idx`, in-place.
 	template<typename... Args>
 	void insert(size_t idx, Args&&... args);
@@ -217,6 +248,28 @@ public:
 	///   - `end - start <= size()`
 	void remove(size_t start, size_t end);
 
+	/// Erases and returns the element at `idx`, replacing it with the last element.
+	///
+	/// Doesn't preserve the order of the elements, but it takes constant time.
+	///
+	/// @pre
+	///   - `idx < size()`
+	auto swap_remove(size_t idx) -> T;
+
+	/// Erases all the elements for which `pred` returns `true`, preserving the order of the other elements.
+	///
+	/// Every element is visited exactly once, and consecutive elements that are kept are relocated together.
+	///
+	/// @returns The number of erased elements.
+	template<typename F>
+	auto remove_if(F pred) -> size_t;
+
+	/// Keeps only the elements for which `pred` returns `true`, preserving their order.
+	///
+	/// @returns The number of erased elements.
+	template<typename F>
+	auto retain(F pred) -> size_t;
+
 	void swap(Array& other) noexcept;
 
 	/// @}
@@ -228,15 +281,13 @@ private:
 
 	auto as_raw_span() -> Span<T> { return Span(this->data(), this->capacity()); }
 
-	auto allocate_amortized(size_t count) const -> MemoryBlock {
-		BPL_DEBUG_ASSERT(count <= std::numeric_limits<size_t>::max() / sizeof(T));
-		size_t bytes = count * sizeof(T);
-		if (bytes >= std::numeric_limits<size_t>::max() / 2) {
-			bytes = std::numeric_limits<size_t>::max();
-		} else {
-			bytes = bpl::max(this->capacity() * sizeof(T) * 2, bytes);
+	// Increases the capacity to fit at least `count` elements, as computed by the growth policy.
+	void grow(size_t count) {
+		if (count <= this->capacity()) {
+			return;
 		}
-		return m_allocator.allocate(bytes, this->alignment());
+		BPL_DEBUG_ASSERT(count <= std::numeric_limits<size_t>::max() / sizeof(T));
+		this->reserve(G::grow(this->capacity() * sizeof(T), count * sizeof(T)) / sizeof(T));
 	}
 
 	void deallocate() {
@@ -247,12 +298,12 @@ private:
 	}
 };
 
-template<relocatable T, Allocator A>
-Array<T, A>::Array(Array& other) : Array(other.data(), other.size()) {
+template<relocatable T, Allocator A, GrowthPolicy G>
+Array<T, A, G>::Array(Array& other) : Array(other.data(), other.size()) {
 }
 
-template<relocatable T, Allocator A>
-auto Array<T, A>::operator=(const Array& other) -> Array<T, A>& {
+template<relocatable T, Allocator A, GrowthPolicy G>
+auto Array<T, A, G>::operator=(const Array& other) -> Array<T, A, G>& {
 	if (this == &other) {
 		return *this;
 	}
@@ -260,17 +311,14 @@ auto Array<T, A>::operator=(const Array& other) -> Array<T, A>& {
 	return *this;
 }
 
-template<relocatable T, Allocator A>
-Array<T, A>::Array(Array&& other) noexcept {
-	this->clear();
-	this->deallocate();
-	m_block = std::exchange(other.m_block, {});
-	m_count = std::exchange(other.m_count, 0);
-	m_allocator = std::move(other.m_allocator); // NOLINT(cppcoreguidelines-prefer-member-initializer)
-}
+template<relocatable T, Allocator A, GrowthPolicy G>
+Array<T, A, G>::Array(Array&& other) noexcept
+	: m_block(std::exchange(other.m_block, {})),
+	  m_count(std::exchange(other.m_count, 0)),
+	  m_allocator(std::move(other.m_allocator)) {}
 
-template<relocatable T, Allocator A>
-auto Array<T, A>::operator=(Array&& other) noexcept -> Array<T, A>& {
+template<relocatable T, Allocator A, GrowthPolicy G>
+auto Array<T, A, G>::operator=(Array&& other) noexcept -> Array<T, A, G>& {
 	this->clear();
 	this->deallocate();
 	m_block = std::exchange(other.m_block, {});
@@ -279,49 +327,93 @@ auto Array<T, A>::operator=(Array&& other) noexcept -> Array<T, A>& {
 	return *this;
 }
 
-template<relocatable T, Allocator A>
-Array<T, A>::~Array() {
+template<relocatable T, Allocator A, GrowthPolicy G>
+Array<T, A, G>::~Array() {
 	this->clear();
 	this->deallocate();
 }
 
-template<relocatable T, Allocator A>
-Array<T, A>::Array(A&& allocator) : m_allocator(std::move(allocator)) {
+template<relocatable T, Allocator A, GrowthPolicy G>
+Array<T, A, G>::Array(A&& allocator) : m_allocator(std::move(allocator)) {
 }
 
-template<relocatable T, Allocator A>
-void Array<T, A>::reserve(size_t count) {
+template<relocatable T, Allocator A, GrowthPolicy G>
+void Array<T, A, G>::reserve(size_t count) {
 	if (count <= this->capacity()) {
 		return;
 	}
+	if constexpr (GrowableAllocator<A>) {
+		if (this->data() != nullptr) {
+			MemoryBlock grown_block =
+				m_allocator.try_grow(m_block, this->alignment(), count * sizeof(T) - m_block.size);
+			if (grown_block.ptr != nullptr) {
+				m_block = grown_block;
+				return;
+			}
+		}
+	}
+	if constexpr (ReallocatableAllocator<A> && trivially_relocatable<T>) {
+		if (this->data() != nullptr) {
+			MemoryBlock new_block = m_allocator.reallocate(m_block, this->alignment(), count * sizeof(T));
+			if (new_block.ptr != nullptr) {
+				m_block = new_block;
+				return;
+			}
+		}
+	}
 	MemoryBlock new_block = m_allocator.allocate(count * sizeof(T), this->alignment());
 	relocate(*this, Span<T>(static_cast<T*>(new_block.ptr), new_block.size / sizeof(T)));
-	m_allocator.deallocate(m_block, this->alignment());
+	this->deallocate();
 	m_block = new_block;
 }
 
-template<relocatable T, Allocator A>
-void Array<T, A>::clear() {
+template<relocatable T, Allocator A, GrowthPolicy G>
+void Array<T, A, G>::shrink_to_fit() {
+	if (this->capacity() == this->size()) {
+		return;
+	}
+	if (this->empty()) {
+		this->deallocate();
+		return;
+	}
+	if constexpr (ShrinkableAllocator<A>) {
+		if (m_allocator.try_shrink(m_block, this->alignment(), this->size_bytes())) {
+			m_block.size = this->size_bytes();
+		}
+	} else {
+		MemoryBlock new_block = m_allocator.allocate(this->size_bytes(), this->alignment());
+		if (new_block.size >= m_block.size) {
+			m_allocator.deallocate(new_block, this->alignment());
+			return;
+		}
+		relocate(*this, Span<T>(static_cast<T*>(new_block.ptr), new_block.size / sizeof(T)));
+		this->deallocate();
+		m_block = new_block;
+	}
+}
+
+template<relocatable T, Allocator A, GrowthPolicy G>
+void Array<T, A, G>::clear() {
 	destroy_backward(*this);
 	m_count = 0;
 }
 
-template<relocatable T, Allocator A>
-void Array<T, A>::resize_uninit(size_t count) {
+template<relocatable T, Allocator A, GrowthPolicy G>
+void Array<T, A, G>::resize_uninit(size_t count) {
 	if (count > this->capacity()) {
-		this->reserve(count);
+		this->grow(count);
 	} else if (count < this->size()) {
 		destroy_backward(Span(*this)[{ .start = count }]);
 	}
 	m_count = count;
 }
 
-template<relocatable T, Allocator A>
+template<relocatable T, Allocator A, GrowthPolicy G>
 template<typename... Args>
-void Array<T, A>::resize(size_t count, Args&&... args) {
+void Array<T, A, G>::resize(size_t count, Args&&... args) {
 	if (count > this->size()) {
 		if (count > this->capacity()) {
-			this->reserve(count);
+			this->grow(count);
 		}
 		construct(this->as_raw_span()[{ .start = this->size(), .end = count }], std::forward<Args>(args)...);
 	} else if (count < this->size()) {
@@ -330,8 +422,8 @@ void Array<T, A>::resize(size_t count, Args&&... args) {
 	m_count = count;
 }
 
-template<relocatable T, Allocator A>
-void Array<T, A>::assign(size_t count, const T& x) {
+template<relocatable T, Allocator A, GrowthPolicy G>
+void Array<T, A, G>::assign(size_t count, const T& x) {
 	if (count <= this->capacity()) {
 		if (count <= this->size()) {
 			fill(Span(*this)[{ .count = count }], x);
@@ -340,15 +432,15 @@ void Array<T, A>::assign(size_t count, const T& x) {
 			construct(this->as_raw_span()[{ .start = this->size(), .end = count }]);
 		}
 	} else {
-		*this = Array<T, A>(uninit, std::move(m_allocator), count);
+		*this = Array<T, A, G>(uninit, std::move(m_allocator), count);
 		construct(Span(*this)[{ .count = count }], x);
 	}
 	m_count = count;
 }
 
-template<relocatable T, Allocator A>
+template<relocatable T, Allocator A, GrowthPolicy G>
 template<sized_range R>
-void Array<T, A>::assign(R&& range) {
+void Array<T, A, G>::assign(R&& range) {
 	if (bpl::size(range) <= this->capacity()) {
 		if (bpl::size(range) <= this->size()) {
 			copy(range, *this);
@@ -357,84 +449,140 @@ void Array<T, A>::assign(R&& range) {
 			std::uninitialized_copy_n(bpl::begin(range) + this->size(), bpl::size(range) - this->size(), this->end());
 		}
 	} else {
-		*this = Array<T, A>(uninit, std::move(m_allocator), bpl::size(range));
+		*this = Array<T, A, G>(uninit, std::move(m_allocator), bpl::size(range));
 		uninitialized_copy(range, *this);
 	}
 	m_count = bpl::size(range);
 }
 
-template<relocatable T, Allocator A>
+template<relocatable T, Allocator A, GrowthPolicy G>
 template<typename... Args>
-void Array<T, A>::append(Args&&... args) {
-	this->reserve(this->size() + 1);
+void Array<T, A, G>::append(Args&&... args) {
+	this->grow(this->size() + 1);
 	std::construct_at(this->end(), std::forward<Args>(args)...);
 	m_count += 1;
 }
 
-template<relocatable T, Allocator A>
+template<relocatable T, Allocator A, GrowthPolicy G>
 template<typename... Args>
-void Array<T, A>::append_n(size_t n, Args&&... args) {
-	this->reserve(this->size() + n);
+void Array<T, A, G>::append_n(size_t n, Args&&... args) {
+	this->grow(this->size() + n);
 	m_count += construct(this->as_raw_span()[{ .start = this->size(), .count = n }], std::forward<Args>(args)...);
 }
 
-template<relocatable T, Allocator A>
+template<relocatable T, Allocator A, GrowthPolicy G>
 template<range R>
-void Array<T, A>::append_range(R&& range) {
+void Array<T, A, G>::append_range(R&& range) {
 	for (const auto& element : range) {
 		this->append(element);
 	}
 }
 
-template<relocatable T, Allocator A>
+template<relocatable T, Allocator A, GrowthPolicy G>
 template<contiguous_range R>
-void Array<T, A>::append_range(R&& range) {
-	this->reserve(this->size() + bpl::size(range));
+void Array<T, A, G>::append_range(R&& range) {
+	this->grow(this->size() + bpl::size(range));
 	m_count += uninitialized_copy(range, this->as_raw_span()[{ .start = this->size() }]);
 }
 
-template<relocatable T, Allocator A>
+template<relocatable T, Allocator A, GrowthPolicy G>
+auto Array<T, A, G>::append_uninit(size_t n) -> Span<T> {
+	this->grow(this->size() + n);
+	return this->as_raw_span()[{ .start = this->size(), .count = n }];
+}
+
+template<relocatable T, Allocator A, GrowthPolicy G>
+void Array<T, A, G>::commit(size_t n) {
+	BPL_ASSERT(n <= this->capacity() - this->size());
+	m_count += n;
+}
+
+template<relocatable T, Allocator A, GrowthPolicy G>
 template<typename... Args>
-void Array<T, A>::insert(size_t i, Args&&... args) {
-	this->reserve(this->size() + 1);
-	relocate_backward(Span(*this)[{ .start = i }], this->as_raw_span()[{ .start = this->size() + 1 }]);
+void Array<T, A, G>::insert(size_t i, Args&&... args) {
+	this->grow(this->size() + 1);
+	relocate_backward(Span(*this)[{ .start = i }], this->as_raw_span()[{ .end = this->size() + 1 }]);
 	std::construct_at(this->data() + i, std::forward<Args>(args)...);
 	m_count += 1;
 }
 
-template<relocatable T, Allocator A>
+template<relocatable T, Allocator A, GrowthPolicy G>
 template<sized_range R>
-void Array<T, A>::insert_range(size_t idx, R&& range) {
+void Array<T, A, G>::insert_range(size_t idx, R&& range) {
 	if (bpl::size(range) == 0) {
 		return;
 	}
-	this->reserve(this->size() + bpl::size(range));
+	this->grow(this->size() + bpl::size(range));
 	relocate_backward(Span(*this)[{ .start = idx }], this->as_raw_span()[{ .end = this->size() + bpl::size(range) }]);
 	m_count += uninitialized_copy(range, this->as_raw_span()[{ .start = idx }]);
 }
 
-template<relocatable T, Allocator A>
-auto Array<T, A>::remove(size_t idx) -> T {
+template<relocatable T, Allocator A, GrowthPolicy G>
+auto Array<T, A, G>::remove(size_t idx) -> T {
 	BPL_ASSERT(idx < this->size());
 	T x = std::move(this->operator[](idx));
 	std::destroy_at(std::addressof(this->operator[](idx)));
-	copy(Span(*this)[{ .start = idx + 1 }], Span(*this)[{ .start = idx }]);
+	relocate(Span(*this)[{ .start = idx + 1 }], Span(*this)[{ .start = idx }]);
 	m_count -= 1;
 	return x;
 }
 
-template<relocatable T, Allocator A>
-void Array<T, A>::remove(size_t start, size_t end) {
+template<relocatable T, Allocator A, GrowthPolicy G>
+void Array<T, A, G>::remove(size_t start, size_t end) {
 	BPL_DEBUG_ASSERT(start <= this->size());
 	BPL_DEBUG_ASSERT(end <= this->size());
 	BPL_DEBUG_ASSERT(end - start <= this->size());
 	destroy_backward(Span(*this)[{ .start = start, .end = end }]);
-	copy(Span(*this)[{ .start = end }], Span(*this)[{ .start = start }]);
+	relocate(Span(*this)[{ .start = end }], Span(*this)[{ .start = start }]);
 	m_count -= end - start;
 }
 
-template<relocatable T, Allocator A>
-void Array<T, A>::swap(Array& other) noexcept {
+template<relocatable T, Allocator A, GrowthPolicy G>
+auto Array<T, A, G>::swap_remove(size_t idx) -> T {
+	BPL_ASSERT(idx < this->size());
+	T x = std::move(this->operator[](idx));
+	std::destroy_at(std::addressof(this->operator[](idx)));
+	if (idx != this->size() - 1) {
+		relocate(Span(*this)[{ .start = this->size() - 1 }], Span(*this)[{ .start = idx, .count = 1 }]);
+	}
+	m_count -= 1;
+	return x;
+}
+
+template<relocatable T, Allocator A, GrowthPolicy G>
+template<typename F>
+auto Array<T, A, G>::remove_if(F pred) -> size_t {
+	Span<T> elements(*this);
+	size_t kept = 0;
+	size_t i = 0;
+	while (i < elements.size()) {
+		const size_t run_start = i;
+		while (i < elements.size() && !pred(std::as_const(elements[i]))) {
+			i += 1;
+		}
+		if (kept != run_start) {
+			relocate(elements[{ .start = run_start, .end = i }], elements[{ .start = kept, .count = i - run_start }]);
+		}
+		kept += i - run_start;
+		if (i < elements.size()) {
+			// SAFETY: `pred` returned `true` for this element
+			std::destroy_at(std::addressof(elements[i]));
+			i += 1;
+		}
+	}
+	const size_t removed = this->size() - kept;
+	m_count = kept;
+	return removed;
+}
+
+template<relocatable T, Allocator A, GrowthPolicy G>
+template<typename F>
+auto Array<T, A, G>::retain(F pred) -> size_t {
+	return this->remove_if([&pred](const T& x) { return !pred(x); });
+}
+
+template<relocatable T, Allocator A, GrowthPolicy G>
+void Array<T, A, G>::swap(Array& other) noexcept {
 	std::swap(m_block, other.m_block);
 	std::swap(m_count, other.m_count);
 	std::swap(m_allocator, other.m_allocator);
@@ -6,8 +6,17 @@
 /// @file
 /// Binary tree data structures and algorithms.
 
+#include <bpl/allocator.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ranges.hpp>
+#include <bpl/tags.hpp>
+
+#include <iterator>
+#include <new>
 #include <utility>
 
+#include <cstddef>
+
 namespace bpl {
 
 template<typename T>
@@ -23,7 +32,11 @@ struct BinaryTreeNode {
 	BinaryTreeNode(T value, BinaryTreeNode* left, BinaryTreeNode* right) : value(value), left(left), right(right) {}
 };
 
-template<typename T>
+/// A binary search tree.
+///
+/// Nodes are allocated from `A`. The constructor from a range allocates them in batches, so it calls the allocator
+/// about `n / 64` times when `A` is a `BatchAllocator`.
+template<typename T, Allocator A = GlobalAllocator>
 class BinaryTree {
 public:
 	BinaryTreeNode<T>* root = nullptr;
@@ -36,26 +49,58 @@ public:
 	BinaryTree(const BinaryTree&) = delete;
 	auto operator=(const BinaryTree&) -> BinaryTree& = delete;
 
-	BinaryTree(BinaryTree&& other) noexcept : root(std::exchange(other.root, nullptr)) {}
+	BinaryTree(BinaryTree&& other) noexcept
+		: root(std::exchange(other.root, nullptr)),
+		  m_node_size(other.m_node_size),
+		  m_allocator(std::move(other.m_allocator)) {}
 	auto operator=(BinaryTree&& other) noexcept -> BinaryTree& {
-		root = std::exchange(other.root, nullptr);
+		if (this != &other) {
+			this->destroy_nodes();
+			root = std::exchange(other.root, nullptr);
+			m_node_size = other.m_node_size;
+			m_allocator = std::move(other.m_allocator);
+		}
 		return *this;
 	}
 
-	~BinaryTree() {
-		traverse_post_order([](BinaryTreeNode<T>*& node) { delete node; });
-	}
+	~BinaryTree() { this->destroy_nodes(); }
 
 	/// @}
 
 	/// @name Constructors
 	/// @{
 
-	explicit BinaryTree(BinaryTreeNode<T>* root) : root(root) {}
+	/// Creates an empty tree with a custom allocator.
+	explicit BinaryTree(A&& allocator) : m_allocator(std::move(allocator)) {}
 
-	explicit BinaryTree(const T& x) : root(BinaryTreeNode(x)) {}
+	explicit BinaryTree(const T& x) { this->root = this->make_node(x); }
 
-	BinaryTree(const T& x, BinaryTreeNode<T>* left, BinaryTreeNode<T>* right) : root(BinaryTreeNode(x, left, right)) {}
+	/// Creates a tree whose root holds `x`, with the nodes of `left` and `right` as its subtrees.
+	///
+	/// The tree takes the allocator of `left`, so the nodes are deallocated by the allocator that allocated them.
+	///
+	/// @pre
+	///   - The allocators of `left` and `right` are equal.
+	BinaryTree(const T& x, BinaryTree&& left, BinaryTree&& right)
+		: m_node_size(left.m_node_size),
+		  m_allocator(std::move(left.m_allocator)) {
+		this->root = this->make_node(x);
+		this->root->left = std::exchange(left.root, nullptr);
+		this->root->right = std::exchange(right.root, nullptr);
+	}
+
+	/// Creates a tree by inserting the elements of the range `r` in order.
+	template<typename R>
+	explicit BinaryTree(from_range_t, R&& r) : BinaryTree(from_range, A{}, std::forward<R>(r)) {}
+	template<typename R>
+	explicit BinaryTree(from_range_t, A&& allocator, R&& r) : m_allocator(std::move(allocator)) {
+		auto it = bpl::begin(r);
+		const auto count = static_cast<size_t>(std::distance(it, bpl::end(r)));
+		detail::allocate_nodes<BinaryTreeNode<T>>(m_allocator, count, m_node_size, [&](void* ptr) {
+			insert_node_fn(this->root, ::new (ptr) BinaryTreeNode<T>(*it));
+			++it;
+		});
+	}
 
 	/// @}
 
@@ -95,9 +140,29 @@ public:
 		traverse_post_order_fn(this->root, f);
 	}
 
-	auto insert(const T& x) -> BinaryTreeNode<T>* { return insert_fn(this->root, x); }
+	auto insert(const T& x) -> BinaryTreeNode<T>* { return insert_node_fn(this->root, this->make_node(x)); }
+
+	/// Returns a const reference to the allocator.
+	auto allocator() const -> const A& { return m_allocator; }
 
 private:
+	// The size of the blocks returned by the allocator for each node
+	size_t m_node_size = sizeof(BinaryTreeNode<T>);
+	[[no_unique_address]] A m_allocator{};
+
+	auto make_node(const T& x) -> BinaryTreeNode<T>* {
+		MemoryBlock block = m_allocator.allocate(sizeof(BinaryTreeNode<T>), alignof(BinaryTreeNode<T>));
+		BPL_ASSERT(block.ptr != nullptr);
+		m_node_size = block.size;
+		return ::new (block.ptr) BinaryTreeNode<T>(x);
+	}
+
+	void destroy_nodes() {
+		detail::NodeDeallocator<BinaryTreeNode<T>, A> deallocator(m_allocator, m_node_size);
+		traverse_post_order([&deallocator](BinaryTreeNode<T>* node) { deallocator.push(node); });
+		this->root = nullptr;
+	}
+
 	template<typename F>
 	void traverse_post_order_fn(BinaryTreeNode<T>* node, F f) const {
 		if (node == nullptr) {
@@ -108,17 +173,18 @@ private:
 		f(node);
 	}
 
-	auto insert_fn(BinaryTreeNode<T>*& node, const T& x) -> BinaryTreeNode<T>* {
+	// Links `new_node` as a leaf of the subtree rooted at `node`.
+	static auto insert_node_fn(BinaryTreeNode<T>*& node, BinaryTreeNode<T>* new_node) -> BinaryTreeNode<T>* {
 		if (node == nullptr) {
-			node = ::new BinaryTreeNode<T>(x);
+			node = new_node;
 			return node;
 		}
 
-		if (x < node->value) {
-			return insert_fn(node->left, x);
+		if (new_node->value < node->value) {
+			return insert_node_fn(node->left, new_node);
 		}
 
-		return insert_fn(node->right, x);
+		return insert_node_fn(node->right, new_node);
 	}
 };
 
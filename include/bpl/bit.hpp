@@ -92,6 +92,30 @@ constexpr auto is_pow2(T x) -> bool {
 	return std::has_single_bit(x);
 }
 
+/// Finds the least significant bit set in `x`.
+///
+/// @pre
+///   - `x != 0`.
+///
+/// @returns The index of the bit, counting from the least significant bit.
+template<std::unsigned_integral T>
+constexpr auto find_first_set(T x) -> uint32_t {
+	BPL_DEBUG_ASSERT(x != 0);
+	return static_cast<uint32_t>(std::countr_zero(x));
+}
+
+/// Finds the most significant bit set in `x`, i.e., computes `floor(log2(x))`.
+///
+/// @pre
+///   - `x != 0`.
+///
+/// @returns The index of the bit, counting from the least significant bit.
+template<std::unsigned_integral T>
+constexpr auto find_last_set(T x) -> uint32_t {
+	BPL_DEBUG_ASSERT(x != 0);
+	return static_cast<uint32_t>(bits_of<T> - 1 - static_cast<size_t>(std::countl_zero(x)));
+}
+
 /// Computes a number that is less or equal to `x` and a multiple of `alignment`.
 ///
 /// @pre
@@ -0,0 +1,331 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <bpl/allocator.hpp>
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/growth.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/span.hpp>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+
+namespace bpl {
+
+/// An iterator over the elements of a `BucketArray`, in order.
+///
+/// Appending an element may move the table of buckets, which invalidates the iterators but not the elements.
+template<typename T, size_t BucketSize>
+class BucketArrayIterator {
+public:
+	/// @name Types
+	/// @{
+
+	using value_type = std::remove_const_t<T>;
+	using difference_type = std::ptrdiff_t;
+
+	/// @}
+
+	/// @name Special member functions
+	/// @{
+
+	BucketArrayIterator() = default;
+
+	/// @}
+
+	/// @name Constructors
+	/// @{
+
+	BucketArrayIterator(const MemoryBlock* buckets, size_t idx) : m_buckets(buckets), m_idx(idx) {}
+
+	/// @}
+
+	/// @name Operators
+	/// @{
+
+	auto operator*() const -> T& { return static_cast<T*>(m_buckets[m_idx / BucketSize].ptr)[m_idx % BucketSize]; }
+
+	auto operator->() const -> T* { return &**this; }
+
+	auto operator++() -> BucketArrayIterator& {
+		m_idx += 1;
+		return *this;
+	}
+
+	auto operator++(int) -> BucketArrayIterator {
+		BucketArrayIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	auto operator==(const BucketArrayIterator&) const -> bool = default;
+
+	/// @}
+
+private:
+	const MemoryBlock* m_buckets = nullptr;
+	size_t m_idx = 0;
+};
+
+/// A dynamic array made of fixed-size buckets, whose elements never move.
+///
+/// Appending an element takes constant time and never relocates the other elements, so pointers and references to
+/// them stay valid until they're destroyed. Each bucket is allocated separately and stores `BucketSize` contiguous
+/// elements.
+///
+/// The elements can be traversed with `begin()` and `end()`, or bucket by bucket with `bucket()`, whose elements are
+/// contiguous.
+///
+/// @tparam BucketSize The number of elements in each bucket, a power of 2.
+template<typename T, size_t BucketSize = 64, Allocator A = GlobalAllocator>
+class BucketArray {
+	static_assert(is_pow2(BucketSize), "The bucket size must be a power of 2.");
+
+public:
+	/// @name Special member functions
+	/// @{
+
+	/// Constructs an empty array.
+	BucketArray() = default;
+
+	BucketArray(const BucketArray&) = delete;
+	auto operator=(const BucketArray&) -> BucketArray& = delete;
+
+	BucketArray(BucketArray&& other) noexcept
+		: m_table(std::exchange(other.m_table, {})),
+		  m_bucket_count(std::exchange(other.m_bucket_count, 0)),
+		  m_count(std::exchange(other.m_count, 0)),
+		  m_allocator(std::move(other.m_allocator)) {}
+	auto operator=(BucketArray&& other) noexcept -> BucketArray& {
+		if (this != &other) {
+			this->release();
+			m_table = std::exchange(other.m_table, {});
+			m_bucket_count = std::exchange(other.m_bucket_count, 0);
+			m_count = std::exchange(other.m_count, 0);
+			m_allocator = std::move(other.m_allocator);
+		}
+		return *this;
+	}
+
+	~BucketArray() { this->release(); }
+
+	/// @}
+
+	/// @name Constructors
+	/// @{
+
+	/// Constructs an empty array with a custom allocator.
+	explicit BucketArray(A&& allocator) : m_allocator(std::move(allocator)) {}
+
+	/// @}
+
+	/// @name Element access
+	/// @{
+
+	/// Returns a reference to the element at `idx`.
+	///
+	/// @pre
+	///   - `idx < size()`.
+	auto operator[](size_t idx) -> T& {
+		BPL_DEBUG_ASSERT(idx < this->size());
+		return this->bucket_data(idx / BucketSize)[idx % BucketSize];
+	}
+	auto operator[](size_t idx) const -> const T& {
+		BPL_DEBUG_ASSERT(idx < this->size());
+		return this->bucket_data(idx / BucketSize)[idx % BucketSize];
+	}
+
+	/// Returns a reference to the element at `idx`.
+	///
+	/// Aborts if `idx` is out-of-bounds.
+	auto at(size_t idx) -> T& {
+		BPL_ASSERT(idx < this->size());
+		return (*this)[idx];
+	}
+	auto at(size_t idx) const -> const T& {
+		BPL_ASSERT(idx < this->size());
+		return (*this)[idx];
+	}
+
+	/// Returns a reference to the last element.
+	///
+	/// Aborts if the array is empty.
+	auto back() -> T& { return this->at(this->size() - 1); }
+	auto back() const -> const T& { return this->at(this->size() - 1); }
+
+	/// Returns the elements in the bucket at `idx`.
+	///
+	/// @pre
+	///   - `idx < bucket_count()`.
+	auto bucket(size_t idx) -> Span<T> { return Span(this->bucket_data(idx), this->bucket_size(idx)); }
+	auto bucket(size_t idx) const -> Span<const T> {
+		return Span<const T>(this->bucket_data(idx), this->bucket_size(idx));
+	}
+
+	/// @}
+
+	/// @name Iterators
+	/// @{
+
+	auto begin() -> BucketArrayIterator<T, BucketSize> { return { this->buckets(), 0 }; }
+	auto begin() const -> BucketArrayIterator<const T, BucketSize> { return { this->buckets(), 0 }; }
+
+	auto end() -> BucketArrayIterator<T, BucketSize> { return { this->buckets(), this->size() }; }
+	auto end() const -> BucketArrayIterator<const T, BucketSize> { return { this->buckets(), this->size() }; }
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the number of elements.
+	auto size() const -> size_t { return m_count; }
+
+	/// Returns `true` if the array has no elements.
+	auto empty() const -> bool { return this->size() == 0; }
+
+	/// Returns the number of elements that can be stored in the allocated buckets.
+	auto capacity() const -> size_t { return m_bucket_count * BucketSize; }
+
+	/// Returns the number of buckets that contain at least one element.
+	auto bucket_count() const -> size_t { return (this->size() + BucketSize - 1) / BucketSize; }
+
+	/// Returns the number of elements in each bucket.
+	static constexpr auto bucket_capacity() -> size_t { return BucketSize; }
+
+	/// Returns a const reference to the underlying allocator.
+	auto allocator() const -> const A& { return m_allocator; }
+
+	/// @}
+
+	/// @name Modifiers
+	/// @{
+
+	/// Appends a new value in-place.
+	///
+	/// @returns A reference to the new element, which stays valid until the element is destroyed.
+	template<typename... Args>
+	auto append(Args&&... args) -> T&;
+
+	/// Destroys and returns the last element.
+	///
+	/// @pre
+	///   - `empty() == false`.
+	auto remove_last() -> T;
+
+	/// Destroys all elements, keeping the allocated buckets.
+	void clear();
+
+	/// @}
+
+private:
+	// The blocks of memory of the buckets
+	MemoryBlock m_table = {};
+	// Number of allocated buckets
+	size_t m_bucket_count = 0;
+	// Number of elements
+	size_t m_count = 0;
+	[[no_unique_address]] A m_allocator{};
+
+	auto buckets() const -> MemoryBlock* { return static_cast<MemoryBlock*>(m_table.ptr); }
+
+	auto bucket_data(size_t idx) const -> T* {
+		BPL_DEBUG_ASSERT(idx < m_bucket_count);
+		return static_cast<T*>(this->buckets()[idx].ptr);
+	}
+
+	auto bucket_size(size_t idx) const -> size_t {
+		BPL_DEBUG_ASSERT(idx < this->bucket_count());
+		return bpl::min(this->size() - (idx * BucketSize), BucketSize);
+	}
+
+	// Allocates a new bucket, growing the table if needed, in-place if the allocator allows it.
+	void add_bucket();
+
+	// Destroys all elements and deallocates all buckets and the table.
+	void release();
+};
+
+template<typename T, size_t BucketSize, Allocator A>
+template<typename... Args>
+auto BucketArray<T, BucketSize, A>::append(Args&&... args) -> T& {
+	if (this->size() == this->capacity()) {
+		this->add_bucket();
+	}
+	T* element = std::construct_at(
+		this->bucket_data(this->size() / BucketSize) + (this->size() % BucketSize), std::forward<Args>(args)...
+	);
+	m_count += 1;
+	return *element;
+}
+
+template<typename T, size_t BucketSize, Allocator A>
+auto BucketArray<T, BucketSize, A>::remove_last() -> T {
+	BPL_ASSERT(!this->empty());
+	T& last = (*this)[this->size() - 1];
+	T x = std::move(last);
+	std::destroy_at(std::addressof(last));
+	m_count -= 1;
+	return x;
+}
+
+template<typename T, size_t BucketSize, Allocator A>
+void BucketArray<T, BucketSize, A>::clear() {
+	for (size_t i = this->bucket_count(); i-- > 0;) {
+		destroy_backward(this->bucket(i));
+	}
+	m_count = 0;
+}
+
+template<typename T, size_t BucketSize, Allocator A>
+void BucketArray<T, BucketSize, A>::add_bucket() {
+	const size_t table_capacity = m_table.size / sizeof(MemoryBlock);
+	if (m_bucket_count == table_capacity) {
+		const size_t new_table_bytes =
+			DoublingGrowth::grow(m_table.size, (m_bucket_count + 1) * sizeof(MemoryBlock));
+		MemoryBlock new_table = {};
+		if constexpr (GrowableAllocator<A>) {
+			if (m_table.ptr != nullptr) {
+				new_table = m_allocator.try_grow(m_table, alignof(MemoryBlock), new_table_bytes - m_table.size);
+			}
+		}
+		if (new_table.ptr == nullptr) {
+			new_table = m_allocator.allocate(new_table_bytes, alignof(MemoryBlock));
+			BPL_ASSERT(new_table.ptr != nullptr);
+			relocate(
+				Span(this->buckets(), m_bucket_count),
+				Span(static_cast<MemoryBlock*>(new_table.ptr), new_table.size / sizeof(MemoryBlock))
+			);
+			if (m_table.ptr != nullptr) {
+				m_allocator.deallocate(m_table, alignof(MemoryBlock));
+			}
+		}
+		m_table = new_table;
+	}
+	MemoryBlock bucket = m_allocator.allocate(BucketSize * sizeof(T), alignof(T));
+	BPL_ASSERT(bucket.ptr != nullptr);
+	std::construct_at(this->buckets() + m_bucket_count, bucket);
+	m_bucket_count += 1;
+}
+
+template<typename T, size_t BucketSize, Allocator A>
+void BucketArray<T, BucketSize, A>::release() {
+	this->clear();
+	for (size_t i = m_bucket_count; i-- > 0;) {
+		m_allocator.deallocate(this->buckets()[i], alignof(T));
+	}
+	m_bucket_count = 0;
+	if (m_table.ptr != nullptr) {
+		m_allocator.deallocate(m_table, alignof(MemoryBlock));
+		m_table = {};
+	}
+}
+
+} // namespace bpl
@@ -0,0 +1,342 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// A buddy allocator over a reserved region of memory.
+
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/os.hpp>
+#include <bpl/ptr.hpp>
+
+#include <bit>
+#include <new>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bpl {
+
+namespace detail {
+
+// A free block of a buddy allocator, in the list of free blocks of its order.
+struct BuddyFreeBlock {
+	BuddyFreeBlock* prev;
+	BuddyFreeBlock* next;
+};
+
+} // namespace detail
+
+/// An allocator of power-of-2 blocks, which splits larger blocks in two halves ("buddies") and merges free buddies
+/// back together.
+///
+/// The allocator manages a region of memory reserved with `reserve_memory`, whose size is a power of 2. A block of
+/// order `k` is `min_block_size() << k` bytes and begins at a multiple of its size. A bitmap with one bit for each
+/// node of the tree of blocks tells which blocks are free, and each order has a list of its free blocks, so that
+/// allocating, deallocating and growing a block take `O(log n)` time. The bitmap is stored in a separate block of
+/// pages.
+class BuddyAllocator {
+public:
+	/// The default size of the smallest blocks, in bytes.
+	static constexpr size_t default_min_block_size = 64;
+
+	//////////////////////////////////////////////////
+	/// @name Special member functions
+	/// @{
+
+	BuddyAllocator() = default;
+
+	BuddyAllocator(const BuddyAllocator&) = delete;
+	auto operator=(const BuddyAllocator&) -> BuddyAllocator& = delete;
+
+	BuddyAllocator(BuddyAllocator&& other) noexcept
+		: m_region(std::exchange(other.m_region, {})),
+		  m_region_size(std::exchange(other.m_region_size, 0)),
+		  m_bitmap(std::exchange(other.m_bitmap, {})),
+		  m_min_block_shift(std::exchange(other.m_min_block_shift, 0)),
+		  m_max_order(std::exchange(other.m_max_order, 0)) {
+		for (uint32_t order = 0; order < max_order_count; ++order) {
+			m_free[order] = std::exchange(other.m_free[order], nullptr);
+		}
+	}
+	auto operator=(BuddyAllocator&& other) noexcept -> BuddyAllocator& {
+		if (this != &other) {
+			this->release();
+			m_region = std::exchange(other.m_region, {});
+			m_region_size = std::exchange(other.m_region_size, 0);
+			m_bitmap = std::exchange(other.m_bitmap, {});
+			m_min_block_shift = std::exchange(other.m_min_block_shift, 0);
+			m_max_order = std::exchange(other.m_max_order, 0);
+			for (uint32_t order = 0; order < max_order_count; ++order) {
+				m_free[order] = std::exchange(other.m_free[order], nullptr);
+			}
+		}
+		return *this;
+	}
+
+	~BuddyAllocator() { this->release(); }
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Constructors
+	/// @{
+
+	/// Creates an allocator that manages `capacity` bytes, rounded up to a power of 2, split in blocks of at least
+	/// `min_block_size` bytes.
+	///
+	/// Aborts if memory allocation fails.
+	///
+	/// @pre
+	///   - `capacity > 0`
+	///   - `min_block_size` is a power of 2, at least `2 * sizeof(void*)`
+	explicit BuddyAllocator(size_t capacity, size_t min_block_size = default_min_block_size) {
+		BPL_ASSERT(capacity > 0);
+		BPL_ASSERT(is_pow2(min_block_size) && min_block_size >= sizeof(detail::BuddyFreeBlock));
+		const size_t region_size = std::bit_ceil(bpl::max(capacity, min_block_size));
+		m_min_block_shift = static_cast<uint32_t>(std::countr_zero(min_block_size));
+		m_max_order = static_cast<uint32_t>(std::countr_zero(region_size)) - m_min_block_shift;
+		BPL_ASSERT(m_max_order < max_order_count);
+
+		m_region = reserve_memory(region_size);
+		BPL_ASSERT(try_commit_memory(m_region));
+		m_region_size = region_size;
+		// Two bits for each block of the smallest order are enough for the whole tree
+		m_bitmap = reserve_memory(bpl::max((size_t{ 2 } << m_max_order) / 8, sizeof(uint64_t)));
+		BPL_ASSERT(try_commit_memory(m_bitmap));
+
+		this->push_free(0, m_max_order);
+	}
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Inspection
+	/// @{
+
+	/// Returns the size of the managed region, in bytes.
+	[[nodiscard]]
+	auto capacity() const -> size_t {
+		return m_region_size;
+	}
+
+	/// Returns the size of the smallest blocks, in bytes.
+	[[nodiscard]]
+	auto min_block_size() const -> size_t {
+		return size_t{ 1 } << m_min_block_shift;
+	}
+
+	/// Returns `true` if `block` lies in the managed region.
+	[[nodiscard]]
+	auto owns(MemoryBlock block) const -> bool {
+		const auto* begin = static_cast<const std::byte*>(m_region.ptr);
+		return pointer_in_range(begin, static_cast<const std::byte*>(block.ptr), begin + m_region_size);
+	}
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	/// Allocates the smallest block that fits `size` bytes aligned to `alignment`.
+	///
+	/// @pre
+	///   - `alignment` is less or equal to the page size
+	///
+	/// @returns The allocated block, or an empty block if there isn't a large enough free block.
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		BPL_DEBUG_ASSERT(alignment <= get_page_size());
+		// Blocks are aligned to their size, up to the page size
+		const size_t bytes = bpl::max(size, alignment);
+		if (bytes > m_region_size) {
+			return {};
+		}
+		const uint32_t order = this->order_of(bytes);
+		uint32_t free_order = order;
+		while (free_order <= m_max_order && m_free[free_order] == nullptr) {
+			free_order += 1;
+		}
+		if (free_order > m_max_order) {
+			return {};
+		}
+		const size_t offset = this->pop_free(free_order);
+		// Splits the block, keeping the lower half
+		while (free_order > order) {
+			free_order -= 1;
+			this->push_free(offset + this->block_size(free_order), free_order);
+		}
+		return { .ptr = static_cast<std::byte*>(m_region.ptr) + offset, .size = this->block_size(order) };
+	}
+
+	/// Deallocates `block`, merging it with its free buddies.
+	///
+	/// @pre
+	///   - `block` was returned by this allocator.
+	void deallocate(MemoryBlock block, size_t /*alignment*/) {
+		BPL_DEBUG_ASSERT(this->owns(block) && is_pow2(block.size));
+		size_t offset = this->offset_of(block);
+		uint32_t order = this->order_of(block.size);
+		while (order < m_max_order) {
+			const size_t buddy = offset ^ this->block_size(order);
+			if (!this->is_free(buddy, order)) {
+				break;
+			}
+			this->remove_free(buddy, order);
+			offset = bpl::min(offset, buddy);
+			order += 1;
+		}
+		this->push_free(offset, order);
+	}
+
+	/// Grows `block` in-place by merging it with the free buddies that follow it.
+	[[nodiscard]]
+	auto try_grow(MemoryBlock block, size_t /*alignment*/, size_t additional) -> MemoryBlock {
+		BPL_DEBUG_ASSERT(this->owns(block) && is_pow2(block.size));
+		if (additional > m_region_size - block.size) {
+			return {};
+		}
+		const size_t offset = this->offset_of(block);
+		const uint32_t order = this->order_of(block.size);
+		const uint32_t new_order = this->order_of(block.size + additional);
+		// The block must be the lower half of each merged block, and each upper half must be free
+		for (uint32_t o = order; o < new_order; ++o) {
+			if (offset % this->block_size(o + 1) != 0 || !this->is_free(offset + this->block_size(o), o)) {
+				return {};
+			}
+		}
+		for (uint32_t o = order; o < new_order; ++o) {
+			this->remove_free(offset + this->block_size(o), o);
+		}
+		return { .ptr = block.ptr, .size = this->block_size(new_order) };
+	}
+
+	/// Shrinks `block` in-place to `new_size` bytes, freeing its upper halves.
+	///
+	/// @returns `false` if `new_size` isn't a power of 2 of at least `min_block_size()` bytes.
+	[[nodiscard]]
+	auto try_shrink(MemoryBlock block, size_t /*alignment*/, size_t new_size) -> bool {
+		BPL_DEBUG_ASSERT(this->owns(block) && is_pow2(block.size));
+		if (new_size > block.size || new_size < this->min_block_size() || !is_pow2(new_size)) {
+			return false;
+		}
+		const size_t offset = this->offset_of(block);
+		const uint32_t new_order = this->order_of(new_size);
+		for (uint32_t o = this->order_of(block.size); o > new_order; --o) {
+			this->push_free(offset + this->block_size(o - 1), o - 1);
+		}
+		return true;
+	}
+
+	/// @}
+
+private:
+	static constexpr uint32_t max_order_count = 64;
+
+	// The pages reserved for the region, which may be larger than the region
+	MemoryBlock m_region = {};
+	// The size of the region covered by the tree of blocks
+	size_t m_region_size = 0;
+	// One bit for each node of the tree of blocks, set if the block is free
+	MemoryBlock m_bitmap = {};
+	uint32_t m_min_block_shift = 0;
+	// The order of the whole region
+	uint32_t m_max_order = 0;
+	// The free blocks of each order
+	detail::BuddyFreeBlock* m_free[max_order_count] = {};
+
+	[[nodiscard]]
+	auto block_size(uint32_t order) const -> size_t {
+		return size_t{ 1 } << (order + m_min_block_shift);
+	}
+
+	// Returns the order of the smallest block that fits `size` bytes.
+	[[nodiscard]]
+	auto order_of(size_t size) const -> uint32_t {
+		const size_t blocks = ((bpl::max(size, size_t{ 1 }) - 1) >> m_min_block_shift) + 1;
+		return static_cast<uint32_t>(std::bit_width(blocks - 1));
+	}
+
+	[[nodiscard]]
+	auto offset_of(MemoryBlock block) const -> size_t {
+		return ptr_to_addr(block.ptr) - ptr_to_addr(m_region.ptr);
+	}
+
+	// Returns the index of the block in the tree, where the root is 1 and the children of `i` are `2 * i` and
+	// `2 * i + 1`.
+	[[nodiscard]]
+	auto node_of(size_t offset, uint32_t order) const -> size_t {
+		return (size_t{ 1 } << (m_max_order - order)) + (offset >> (order + m_min_block_shift));
+	}
+
+	[[nodiscard]]
+	auto bitmap() const -> uint64_t* {
+		return static_cast<uint64_t*>(m_bitmap.ptr);
+	}
+
+	[[nodiscard]]
+	auto is_free(size_t offset, uint32_t order) const -> bool {
+		const size_t node = this->node_of(offset, order);
+		return ((this->bitmap()[node / 64] >> (node % 64)) & 1) != 0;
+	}
+
+	void set_free(size_t offset, uint32_t order, bool free) {
+		const size_t node = this->node_of(offset, order);
+		const uint64_t mask = uint64_t{ 1 } << (node % 64);
+		this->bitmap()[node / 64] = free ? (this->bitmap()[node / 64] | mask) : (this->bitmap()[node / 64] & ~mask);
+	}
+
+	void push_free(size_t offset, uint32_t order) {
+		auto* block = ::new (static_cast<std::byte*>(m_region.ptr) + offset)
+			detail::BuddyFreeBlock{ .prev = nullptr, .next = m_free[order] };
+		if (m_free[order] != nullptr) {
+			m_free[order]->prev = block;
+		}
+		m_free[order] = block;
+		this->set_free(offset, order, true);
+	}
+
+	[[nodiscard]]
+	auto pop_free(uint32_t order) -> size_t {
+		detail::BuddyFreeBlock* block = m_free[order];
+		const size_t offset = ptr_to_addr(block) - ptr_to_addr(m_region.ptr);
+		this->remove_free(offset, order);
+		return offset;
+	}
+
+	void remove_free(size_t offset, uint32_t order) {
+		auto* block = addr_to_ptr<detail::BuddyFreeBlock>(ptr_to_addr(m_region.ptr) + offset);
+		if (block->prev != nullptr) {
+			block->prev->next = block->next;
+		} else {
+			m_free[order] = block->next;
+		}
+		if (block->next != nullptr) {
+			block->next->prev = block->prev;
+		}
+		this->set_free(offset, order, false);
+	}
+
+	// Releases the region and the bitmap.
+	void release() {
+		if (m_region.ptr != nullptr) {
+			(void) try_decommit_memory(m_region);
+			(void) try_release_memory(m_region);
+			(void) try_decommit_memory(m_bitmap);
+			(void) try_release_memory(m_bitmap);
+			m_region = {};
+			m_region_size = 0;
+			m_bitmap = {};
+		}
+		for (detail::BuddyFreeBlock*& free : m_free) {
+			free = nullptr;
+		}
+	}
+};
+
+} // namespace bpl
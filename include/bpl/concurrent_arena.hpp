@@ -0,0 +1,274 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// An arena allocator that can be used by multiple threads at the same time.
+
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/literals.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/os.hpp>
+#include <bpl/ptr.hpp>
+
+#include <atomic>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bpl {
+
+/// Options to create a concurrent arena.
+struct ConcurrentArenaOptions {
+	/// The size of the arena, in bytes.
+	size_t capacity = 0;
+	/// The number of bytes that each thread takes from the arena at a time, to allocate from them without touching the
+	/// shared offset. Larger allocations are taken from the arena directly.
+	size_t sub_block_size = 64_KiB;
+};
+
+namespace detail {
+
+// The sub-block of a thread in a concurrent arena.
+struct ConcurrentArenaCache {
+	// The epoch of the arena that owns the sub-block, `0` if the thread has no sub-block
+	uint64_t epoch = 0;
+	uintptr_t begin = 0;
+	uintptr_t end = 0;
+};
+
+// Returns the sub-block of the calling thread.
+inline auto concurrent_arena_cache() -> ConcurrentArenaCache& {
+	thread_local ConcurrentArenaCache cache;
+	return cache;
+}
+
+// Returns a number that was never returned before, to identify the content of a concurrent arena.
+inline auto next_concurrent_arena_epoch() -> uint64_t {
+	static std::atomic<uint64_t> epoch = 1;
+	return epoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+/// An arena allocator that many threads can allocate from at the same time, without locks.
+///
+/// Each thread takes a sub-block from the arena with an atomic fetch-add on the shared offset, then allocates from
+/// its sub-block until it's full, so the shared offset is rarely touched. A thread keeps the sub-block of the last
+/// concurrent arena it allocated from: a thread that alternates between several arenas wastes part of its
+/// sub-blocks.
+///
+/// The size of every block is rounded up to `alignof(std::max_align_t)` bytes.
+///
+/// Memory is never deallocated, except by `clear()`.
+class ConcurrentArena {
+public:
+	//////////////////////////////////////////////////
+	/// @name Special member functions
+	/// @{
+
+	ConcurrentArena() = default;
+
+	/// Copying an arena doesn't make sense.
+	ConcurrentArena(ConcurrentArena&) = delete;
+	/// Copying an arena doesn't make sense.
+	auto operator=(ConcurrentArena&) -> ConcurrentArena& = delete;
+
+	/// @warning Not thread-safe.
+	ConcurrentArena(ConcurrentArena&& other) noexcept
+		: m_block(std::exchange(other.m_block, {})),
+		  m_offset(other.m_offset.exchange(0, std::memory_order_relaxed)),
+		  m_sub_block_size(other.m_sub_block_size),
+		  m_epoch(std::exchange(other.m_epoch, detail::next_concurrent_arena_epoch())) {}
+	/// @warning Not thread-safe.
+	auto operator=(ConcurrentArena&& other) noexcept -> ConcurrentArena& {
+		if (this != &other) {
+			this->release();
+			m_block = std::exchange(other.m_block, {});
+			m_offset.store(other.m_offset.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+			m_sub_block_size = other.m_sub_block_size;
+			m_epoch = std::exchange(other.m_epoch, detail::next_concurrent_arena_epoch());
+		}
+		return *this;
+	}
+
+	~ConcurrentArena() { this->release(); }
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Constructors
+	/// @{
+
+	/// Creates an arena of `capacity` bytes.
+	///
+	/// Aborts if memory allocation fails.
+	///
+	/// @pre
+	///   - `capacity > 0`
+	explicit ConcurrentArena(size_t capacity) : ConcurrentArena(ConcurrentArenaOptions{ .capacity = capacity }) {}
+
+	/// Creates an arena as described by `options`.
+	///
+	/// Aborts if memory allocation fails.
+	///
+	/// @pre
+	///   - `options.capacity > 0`
+	///   - `options.sub_block_size > 0`
+	explicit ConcurrentArena(ConcurrentArenaOptions options)
+		: m_sub_block_size(align_forward(options.sub_block_size, grain)) {
+		BPL_ASSERT(options.capacity > 0);
+		BPL_ASSERT(options.sub_block_size > 0);
+		m_block = reserve_memory(options.capacity);
+		BPL_ASSERT(try_commit_memory(m_block));
+	}
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Inspection
+	/// @{
+
+	/// Returns the size of the arena in bytes.
+	[[nodiscard]]
+	auto capacity() const -> size_t {
+		return m_block.size;
+	}
+
+	/// Returns the number of bytes taken from the arena, including the unused part of the sub-blocks of the threads.
+	[[nodiscard]]
+	auto size() const -> size_t {
+		return bpl::min(m_offset.load(std::memory_order_relaxed), m_block.size);
+	}
+
+	[[nodiscard]]
+	auto empty() const -> bool {
+		return this->size() == 0;
+	}
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Methods
+	/// @{
+
+	/// Allocates `size` bytes aligned to `alignment`.
+	///
+	/// Thread-safe.
+	///
+	/// @returns The allocated block, or an empty block if the arena is full.
+	[[nodiscard]]
+	auto push(size_t size, size_t alignment) -> MemoryBlock {
+		BPL_DEBUG_ASSERT(is_pow2(alignment));
+		detail::ConcurrentArenaCache& cache = detail::concurrent_arena_cache();
+		if (cache.epoch == m_epoch) {
+			if (MemoryBlock block = push_in_sub_block(cache, size, alignment); block.ptr != nullptr) {
+				return block;
+			}
+		}
+		if (size + alignment > m_sub_block_size / 2) {
+			return this->push_shared(size, alignment);
+		}
+		MemoryBlock sub_block = this->push_shared(m_sub_block_size, grain);
+		if (sub_block.ptr == nullptr) {
+			return {};
+		}
+		cache = {
+			.epoch = m_epoch,
+			.begin = ptr_to_addr(sub_block.ptr),
+			.end = ptr_to_addr(sub_block.ptr) + sub_block.size,
+		};
+		MemoryBlock block = push_in_sub_block(cache, size, alignment);
+		BPL_DEBUG_ASSERT(block.ptr != nullptr);
+		return block;
+	}
+
+	/// Deallocates all the blocks.
+	///
+	/// @warning Not thread-safe: no other thread may allocate from the arena at the same time.
+	void clear() {
+		m_offset.store(0, std::memory_order_relaxed);
+		// Invalidates the sub-blocks of all the threads
+		m_epoch = detail::next_concurrent_arena_epoch();
+	}
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		return this->push(size, alignment);
+	}
+
+	/// Does nothing, the memory is deallocated by `clear()`.
+	void deallocate(MemoryBlock /*block*/, size_t /*alignment*/) {}
+
+	/// @}
+
+private:
+	// Every offset taken from the shared counter is a multiple of this
+	static constexpr size_t grain = alignof(std::max_align_t);
+
+	MemoryBlock m_block = {};
+	// The number of bytes taken from the arena, which may exceed the capacity when the arena is full
+	std::atomic<size_t> m_offset = 0;
+	size_t m_sub_block_size = 0;
+	// Identifies the sub-blocks taken from the arena since it was last cleared
+	uint64_t m_epoch = detail::next_concurrent_arena_epoch();
+
+	// Takes a block from the arena with a single fetch-add.
+	[[nodiscard]]
+	auto push_shared(size_t size, size_t alignment) -> MemoryBlock {
+		BPL_DEBUG_ASSERT(alignment <= get_page_size());
+		if (size > m_block.size) {
+			return {};
+		}
+		// The offset is always a multiple of `grain`, so only larger alignments need padding
+		const size_t padding = alignment > grain ? alignment - grain : 0;
+		const size_t bytes = align_forward(size, grain) + padding;
+		if (bytes > m_block.size) {
+			return {};
+		}
+		const size_t offset = m_offset.fetch_add(bytes, std::memory_order_relaxed);
+		if (offset > m_block.size - bytes) {
+			return {};
+		}
+		const uintptr_t begin = align_forward(ptr_to_addr(m_block.ptr) + offset, alignment);
+		return { .ptr = addr_to_ptr<void>(begin), .size = align_forward(size, grain) };
+	}
+
+	// Takes a block from the sub-block of this thread, rounded up to `grain` bytes like `push_shared`.
+	[[nodiscard]]
+	static auto push_in_sub_block(detail::ConcurrentArenaCache& cache, size_t size, size_t alignment) -> MemoryBlock {
+		if (size > cache.end - cache.begin) {
+			return {};
+		}
+		const size_t bytes = align_forward(size, grain);
+		const uintptr_t addr_begin = align_forward(cache.begin, alignment);
+		const uintptr_t addr_end = addr_begin + bytes;
+		if (addr_begin < cache.begin || addr_end < addr_begin || addr_end > cache.end) {
+			return {};
+		}
+		cache.begin = addr_end;
+		return { .ptr = addr_to_ptr<void>(addr_begin), .size = bytes };
+	}
+
+	// Releases all the memory reserved by the arena.
+	void release() {
+		if (m_block.ptr != nullptr) {
+			(void) try_decommit_memory(m_block);
+			(void) try_release_memory(m_block);
+			m_block = {};
+		}
+		m_offset.store(0, std::memory_order_relaxed);
+		m_epoch = detail::next_concurrent_arena_epoch();
+	}
+};
+
+} // namespace bpl
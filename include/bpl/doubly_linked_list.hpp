@@ -3,10 +3,13 @@
 
 #pragma once
 
+#include <bpl/allocator.hpp>
 #include <bpl/memory.hpp>
+#include <bpl/ranges.hpp>
 #include <bpl/tags.hpp>
 #include <bpl/utility.hpp>
 
+#include <iterator>
 #include <utility>
 
 #include <cstddef>
@@ -82,7 +85,10 @@ private:
 };
 
 /// A doubly linked list.
-template<typename T>
+///
+/// Nodes are allocated from `A` in batches, so building a list of `n` elements calls the allocator about `n / 64`
+/// times when `A` is a `BatchAllocator`.
+template<typename T, Allocator A = GlobalAllocator>
 class DoublyLinkedList {
 public:
 	// Special member functions
@@ -92,57 +98,53 @@ public:
 	DoublyLinkedList(DoublyLinkedList&) = delete;
 	auto operator=(DoublyLinkedList&) -> DoublyLinkedList& = delete;
 
-	DoublyLinkedList(DoublyLinkedList&& other) noexcept : m_head(std::exchange(other.m_head, nullptr)) {}
+	DoublyLinkedList(DoublyLinkedList&& other) noexcept
+		: m_head(std::exchange(other.m_head, nullptr)),
+		  m_node_size(other.m_node_size),
+		  m_allocator(std::move(other.m_allocator)) {}
 	auto operator=(DoublyLinkedList&& rhs) noexcept -> DoublyLinkedList& {
-		m_head = std::exchange(rhs.m_head, nullptr);
-	}
-
-	~DoublyLinkedList() {
-		DoublyLinkedListNode<T>* node = m_head;
-		while (node != nullptr) {
-			delete std::exchange(node, node->next);
+		if (this != &rhs) {
+			this->destroy_nodes();
+			m_head = std::exchange(rhs.m_head, nullptr);
+			m_node_size = rhs.m_node_size;
+			m_allocator = std::move(rhs.m_allocator);
 		}
+		return *this;
 	}
 
+	~DoublyLinkedList() { this->destroy_nodes(); }
+
 	// Constructors
 
-	explicit DoublyLinkedList(size_t count) {
-		if (count == 0) {
-			return;
-		}
-		m_head = make_node();
-		DoublyLinkedListNode<T>* node = m_head;
-		for (size_t i = 1; i < count; ++i) {
-			node->next = make_node(nullptr, node);
-			node = node->next;
-		}
+	/// Creates an empty list with a custom allocator.
+	explicit DoublyLinkedList(A&& allocator) : m_allocator(std::move(allocator)) {}
+
+	explicit DoublyLinkedList(size_t count) : DoublyLinkedList(A{}, count) {}
+	explicit DoublyLinkedList(A&& allocator, size_t count) : m_allocator(std::move(allocator)) {
+		this->make_nodes(count, [](void* ptr, DoublyLinkedListNode<T>* prev) {
+			return ::new (ptr) DoublyLinkedListNode<T>(nullptr, prev);
+		});
 	}
 
-	DoublyLinkedList(size_t count, const T& x) {
-		if (count == 0) {
-			return;
-		}
-		m_head = make_node();
-		auto node = m_head;
-		for (size_t i = 1; i < count; ++i) {
-			node->next = make_node(nullptr, node, x);
-			node = node->next;
-		}
+	DoublyLinkedList(size_t count, const T& x) : DoublyLinkedList(A{}, count, x) {}
+	DoublyLinkedList(A&& allocator, size_t count, const T& x) : m_allocator(std::move(allocator)) {
+		this->make_nodes(count, [&x](void* ptr, DoublyLinkedListNode<T>* prev) {
+			return ::new (ptr) DoublyLinkedListNode<T>(nullptr, prev, x);
+		});
 	}
 
 	/// @{
 	/// @tparam I Forward iterator.
 	template<typename I>
-	DoublyLinkedList(I begin, I end) {
-		if (begin == end) {
-			return;
-		}
-		m_head = make_node(*begin);
-		auto node = m_head;
-		for (const auto& element : make_range(begin, end)) {
-			node->next = make_node(nullptr, node, element);
-			node = node->next;
-		}
+	DoublyLinkedList(I begin, I end) : DoublyLinkedList(A{}, begin, end) {}
+	template<typename I>
+	DoublyLinkedList(A&& allocator, I begin, I end) : m_allocator(std::move(allocator)) {
+		const auto count = static_cast<size_t>(std::distance(begin, end));
+		this->make_nodes(count, [&begin](void* ptr, DoublyLinkedListNode<T>* prev) {
+			auto* node = ::new (ptr) DoublyLinkedListNode<T>(nullptr, prev, *begin);
+			++begin;
+			return node;
+		});
 	}
 	/// @}
 
@@ -150,12 +152,18 @@ public:
 	/// @tparam R Forward range.
 	template<typename R>
 	DoublyLinkedList(from_range_t, R&& range) : DoublyLinkedList(bpl::begin(range), bpl::end(range)) {}
+	template<typename R>
+	DoublyLinkedList(from_range_t, A&& allocator, R&& range)
+		: DoublyLinkedList(std::move(allocator), bpl::begin(range), bpl::end(range)) {}
 	/// @}
 
 	// Inspection
 
 	auto alignment() const -> size_t { return alignof(DoublyLinkedListNode<T>); }
 
+	/// Returns a const reference to the allocator.
+	auto allocator() const -> const A& { return m_allocator; }
+
 	// Iterators
 
 	auto begin() -> DoublyLinkedListIterator<T> { return DoublyLinkedListIterator(m_head); }
@@ -166,12 +174,33 @@ public:
 
 private:
 	DoublyLinkedListNode<T>* m_head = nullptr;
+	// The size of the blocks returned by the allocator for each node
+	size_t m_node_size = sizeof(DoublyLinkedListNode<T>);
+	[[no_unique_address]] A m_allocator{};
+
+	// Allocates `count` nodes and links them after each other, where `make(ptr, prev)` constructs a node at `ptr` after
+	// `prev` and returns it.
+	template<typename F>
+	void make_nodes(size_t count, F make) {
+		DoublyLinkedListNode<T>* prev = nullptr;
+		detail::allocate_nodes<DoublyLinkedListNode<T>>(m_allocator, count, m_node_size, [&](void* ptr) {
+			DoublyLinkedListNode<T>* node = make(ptr, prev);
+			if (prev != nullptr) {
+				prev->next = node;
+			} else {
+				m_head = node;
+			}
+			prev = node;
+		});
+	}
 
-	/// @param Args Arguments to pass to the constructor of `T`.
-	template<typename... Args>
-	auto make_node(DoublyLinkedListNode<T>* next = nullptr, DoublyLinkedListNode<T>* prev = nullptr, Args&&... args)
-		-> DoublyLinkedListNode<T>* {
-		return ::new DoublyLinkedListNode<T>(next, prev, std::forward<Args>(args)...);
+	void destroy_nodes() {
+		detail::NodeDeallocator<DoublyLinkedListNode<T>, A> deallocator(m_allocator, m_node_size);
+		DoublyLinkedListNode<T>* node = m_head;
+		while (node != nullptr) {
+			deallocator.push(std::exchange(node, node->next));
+		}
+		m_head = nullptr;
 	}
 };
 
@@ -0,0 +1,94 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// Growth policies used by dynamic containers to compute their new capacity.
+
+#include <bpl/bit.hpp>
+#include <bpl/math.hpp>
+#include <bpl/os.hpp>
+
+#include <concepts>
+#include <limits>
+
+#include <cstddef>
+
+namespace bpl {
+
+/// @name Concepts
+/// @{
+
+// clang-format off
+
+/// Computes how many bytes a container should allocate when it grows.
+///
+/// `grow(capacity, required)` receives the current capacity and the number of bytes that must fit, both in bytes, and
+/// returns a number of bytes that is greater or equal to `required`.
+template<typename G>
+concept GrowthPolicy = requires(size_t capacity, size_t required) {
+	{ G::grow(capacity, required) } -> std::same_as<size_t>;
+};
+
+// clang-format on
+
+/// @}
+
+/// @name Growth policies
+/// @{
+
+/// Allocates exactly the required number of bytes.
+///
+/// @warning Appending one element at a time takes quadratic time.
+struct ExactGrowth {
+	static constexpr auto grow(size_t /*capacity*/, size_t required) -> size_t { return required; }
+};
+
+/// Multiplies the capacity by `Numerator / Denominator`, or grows to the required size if it's larger.
+template<size_t Numerator, size_t Denominator>
+struct GeometricGrowth {
+	static_assert(Numerator > Denominator, "The capacity must grow.");
+	static_assert(Denominator > 0);
+
+	static constexpr auto grow(size_t capacity, size_t required) -> size_t {
+		if (auto product = checked_mul(capacity, Numerator)) {
+			return bpl::max(required, *product / Denominator);
+		}
+		return required;
+	}
+};
+
+/// Doubles the capacity.
+using DoublingGrowth = GeometricGrowth<2, 1>;
+
+/// Grows the capacity by half, which lets an allocator reuse previously freed blocks.
+using HalfGrowth = GeometricGrowth<3, 2>;
+
+/// Rounds the size computed by `G` up to a multiple of the page size.
+template<GrowthPolicy G = DoublingGrowth>
+struct PageGrowth {
+	static auto grow(size_t capacity, size_t required) -> size_t {
+		const size_t bytes = G::grow(capacity, required);
+		if (bytes > std::numeric_limits<size_t>::max() - get_page_size()) {
+			return bytes;
+		}
+		return align_forward(bytes, get_page_size());
+	}
+};
+
+/// Rounds the size computed by `G` up to a multiple of the size of a huge page, as returned by `get_huge_page_size()`.
+template<GrowthPolicy G = DoublingGrowth>
+struct HugePageGrowth {
+	static auto grow(size_t capacity, size_t required) -> size_t {
+		const size_t bytes = G::grow(capacity, required);
+		if (bytes > std::numeric_limits<size_t>::max() - get_huge_page_size()) {
+			return bytes;
+		}
+		return align_forward(bytes, get_huge_page_size());
+	}
+};
+
+/// @}
+
+} // namespace bpl
@@ -0,0 +1,341 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <bpl/assert.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ranges.hpp>
+#include <bpl/span.hpp>
+#include <bpl/tags.hpp>
+#include <bpl/traits.hpp>
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+
+namespace bpl {
+
+namespace detail {
+
+// Storage for the elements of an `InplaceArray`, which doesn't construct them.
+template<typename T, size_t Capacity>
+struct inplace_storage {
+	union {
+		T elements[Capacity];
+	};
+
+	constexpr inplace_storage() {}
+
+	constexpr ~inplace_storage()
+	requires trivially_destructible<T>
+	= default;
+	constexpr ~inplace_storage() {}
+};
+
+// Trivial types can be stored in a plain array, which can be used in constant expressions.
+template<typename T, size_t Capacity>
+requires std::is_trivially_default_constructible_v<T> && trivially_destructible<T>
+struct inplace_storage<T, Capacity> {
+	T elements[Capacity];
+};
+
+} // namespace detail
+
+/// A dynamic array with a fixed capacity, which stores its elements inline and never allocates.
+///
+/// It's trivially copyable if `T` is trivially copyable, and it can be used in constant expressions if `T` is
+/// trivially default constructible and trivially destructible.
+template<relocatable T, size_t Capacity>
+class InplaceArray {
+	static_assert(Capacity > 0);
+
+public:
+	/// @name Types
+	/// @{
+
+	/// The smallest unsigned integer that can store the capacity.
+	using size_type = smallest_size_type<Capacity>;
+
+	/// @}
+
+	/// @name Special member functions
+	/// @{
+
+	/// Constructs an empty array.
+	constexpr InplaceArray() = default;
+
+	constexpr InplaceArray(const InplaceArray& other)
+	requires trivially_copyable<T>
+	= default;
+	constexpr InplaceArray(const InplaceArray& other) { this->append_range(other); }
+
+	constexpr auto operator=(const InplaceArray& other) -> InplaceArray&
+	requires trivially_copyable<T>
+	= default;
+	constexpr auto operator=(const InplaceArray& other) -> InplaceArray& {
+		if (this != &other) {
+			this->clear();
+			this->append_range(other);
+		}
+		return *this;
+	}
+
+	constexpr InplaceArray(InplaceArray&& other) noexcept
+	requires trivially_copyable<T>
+	= default;
+	constexpr InplaceArray(InplaceArray&& other) noexcept {
+		m_count = static_cast<size_type>(relocate(other, this->as_raw_span()));
+		other.m_count = 0;
+	}
+
+	constexpr auto operator=(InplaceArray&& other) noexcept -> InplaceArray&
+	requires trivially_copyable<T>
+	= default;
+	constexpr auto operator=(InplaceArray&& other) noexcept -> InplaceArray& {
+		if (this != &other) {
+			this->clear();
+			m_count = static_cast<size_type>(relocate(other, this->as_raw_span()));
+			other.m_count = 0;
+		}
+		return *this;
+	}
+
+	constexpr ~InplaceArray()
+	requires trivially_destructible<T>
+	= default;
+	constexpr ~InplaceArray() { this->clear(); }
+
+	/// @}
+
+	/// @name Constructors
+	/// @{
+
+	/// Constructs an array with `count` elements, constructed in-place.
+	///
+	/// Aborts if `count > capacity()`.
+	template<typename... Args>
+	constexpr explicit InplaceArray(size_t count, Args&&... args) {
+		this->append_n(count, std::forward<Args>(args)...);
+	}
+
+	/// Constructs an array by copying the elements from the range `r`.
+	///
+	/// Aborts if the elements don't fit.
+	template<range R>
+	constexpr explicit InplaceArray(from_range_t, R&& r) {
+		this->append_range(std::forward<R>(r));
+	}
+
+	/// @}
+
+	/// @name Iterators
+	/// @{
+
+	/// Returns a pointer to the first element.
+	constexpr auto data() -> T* { return m_storage.elements; }
+	constexpr auto data() const -> const T* { return m_storage.elements; }
+
+	/// Returns a pointer to the first element.
+	constexpr auto begin() -> T* { return this->data(); }
+	constexpr auto begin() const -> const T* { return this->data(); }
+
+	/// Returns a pointer to one past the last element.
+	constexpr auto end() -> T* { return this->data() + this->size(); }
+	constexpr auto end() const -> const T* { return this->data() + this->size(); }
+
+	/// @}
+
+	/// @name Element access
+	/// @{
+
+	/// Returns a reference to the element at `idx`.
+	///
+	/// @pre
+	///   - `idx` is not out-of-bounds.
+	constexpr auto operator[](size_t idx) -> T& { return Span(*this)[idx]; }
+	constexpr auto operator[](size_t idx) const -> const T& { return Span(*this)[idx]; }
+
+	/// Returns a reference to the element at `idx`.
+	///
+	/// Aborts if `idx` is out-of-bounds.
+	constexpr auto at(size_t idx) -> T& { return Span(*this).at(idx); }
+	constexpr auto at(size_t idx) const -> const T& { return Span(*this).at(idx); }
+
+	/// Returns a reference to the first element.
+	///
+	/// Aborts if the array is empty.
+	constexpr auto front() -> T& { return Span(*this).front(); }
+	constexpr auto front() const -> const T& { return Span(*this).front(); }
+
+	/// Returns a reference to the last element.
+	///
+	/// Aborts if the array is empty.
+	constexpr auto back() -> T& { return Span(*this).back(); }
+	constexpr auto back() const -> const T& { return Span(*this).back(); }
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the number of elements in the container.
+	constexpr auto size() const -> size_t { return m_count; }
+
+	/// Returns the size of the array in bytes.
+	constexpr auto size_bytes() const -> size_t { return this->size() * sizeof(T); }
+
+	/// Returns `true` if the container has no elements.
+	constexpr auto empty() const -> bool { return this->size() == 0; }
+
+	/// Returns `true` if the container can't store any more elements.
+	constexpr auto full() const -> bool { return this->size() == Capacity; }
+
+	/// Returns the maximum number of elements that can be stored.
+	static constexpr auto capacity() -> size_t { return Capacity; }
+
+	/// @}
+
+	/// @name Modifiers
+	/// @{
+
+	/// Destroys all elements in the array.
+	constexpr void clear() {
+		destroy_backward(*this);
+		m_count = 0;
+	}
+
+	/// Resizes array to contain `count` elements, constructing new elements in-place.
+	///
+	/// Aborts if `count > capacity()`.
+	template<typename... Args>
+	constexpr void resize(size_t count, Args&&... args) {
+		BPL_ASSERT(count <= Capacity);
+		if (count > this->size()) {
+			construct(this->as_raw_span()[{ .start = this->size(), .end = count }], std::forward<Args>(args)...);
+		} else if (count < this->size()) {
+			destroy_backward(Span(*this)[{ .start = count }]);
+		}
+		m_count = static_cast<size_type>(count);
+	}
+
+	/// Appends a new value in-place.
+	///
+	/// Aborts if the array is full.
+	template<typename... Args>
+	constexpr void append(Args&&... args) {
+		BPL_ASSERT(!this->full());
+		std::construct_at(this->end(), std::forward<Args>(args)...);
+		m_count += 1;
+	}
+
+	/// Appends a new value in-place if the array isn't full.
+	///
+	/// @returns `true` if the value was appended.
+	template<typename... Args>
+	[[nodiscard]]
+	constexpr auto try_append(Args&&... args) -> bool {
+		if (this->full()) {
+			return false;
+		}
+		std::construct_at(this->end(), std::forward<Args>(args)...);
+		m_count += 1;
+		return true;
+	}
+
+	/// Appends `n` new values in-place.
+	///
+	/// Aborts if the values don't fit.
+	template<typename... Args>
+	constexpr void append_n(size_t n, Args&&... args) {
+		BPL_ASSERT(n <= Capacity - this->size());
+		m_count += static_cast<size_type>(
+			construct(this->as_raw_span()[{ .start = this->size(), .count = n }], std::forward<Args>(args)...)
+		);
+	}
+
+	/// Appends elements from `range`, one at a time.
+	///
+	/// Aborts if the elements don't fit.
+	template<range R>
+	constexpr void append_range(R&& range) {
+		for (const auto& element : range) {
+			this->append(element);
+		}
+	}
+
+	/// Appends elements from `range`.
+	///
+	/// Aborts if the elements don't fit.
+	template<sized_range R>
+	constexpr void append_range(R&& range) {
+		BPL_ASSERT(bpl::size(range) <= Capacity - this->size());
+		m_count += static_cast<size_type>(uninitialized_copy(range, this->as_raw_span()[{ .start = this->size() }]));
+	}
+
+	/// Inserts an element before `idx`, in-place.
+	///
+	/// Aborts if the array is full or `idx > size()`.
+	template<typename... Args>
+	constexpr void insert(size_t idx, Args&&... args) {
+		BPL_ASSERT(idx <= this->size());
+		BPL_ASSERT(!this->full());
+		relocate_backward(Span(*this)[{ .start = idx }], this->as_raw_span()[{ .end = this->size() + 1 }]);
+		std::construct_at(this->data() + idx, std::forward<Args>(args)...);
+		m_count += 1;
+	}
+
+	/// Inserts the elements from `range` before `idx`.
+	///
+	/// Aborts if the elements don't fit or `idx > size()`.
+	template<sized_range R>
+	constexpr void insert_range(size_t idx, R&& range) {
+		BPL_ASSERT(idx <= this->size());
+		BPL_ASSERT(bpl::size(range) <= Capacity - this->size());
+		if (bpl::size(range) == 0) {
+			return;
+		}
+		relocate_backward(
+			Span(*this)[{ .start = idx }], this->as_raw_span()[{ .end = this->size() + bpl::size(range) }]
+		);
+		m_count += static_cast<size_type>(uninitialized_copy(range, this->as_raw_span()[{ .start = idx }]));
+	}
+
+	/// Erases and returns the element at `idx`.
+	///
+	/// @pre
+	///   - `idx < size()`
+	constexpr auto remove(size_t idx) -> T {
+		BPL_ASSERT(idx < this->size());
+		T x = std::move(this->operator[](idx));
+		std::destroy_at(std::addressof(this->operator[](idx)));
+		relocate(Span(*this)[{ .start = idx + 1 }], Span(*this)[{ .start = idx }]);
+		m_count -= 1;
+		return x;
+	}
+
+	/// Erases the elements in `[ start, end )`.
+	///
+	/// @pre
+	///   - `start <= end`
+	///   - `end <= size()`
+	constexpr void remove(size_t start, size_t end) {
+		BPL_DEBUG_ASSERT(start <= end);
+		BPL_DEBUG_ASSERT(end <= this->size());
+		destroy_backward(Span(*this)[{ .start = start, .end = end }]);
+		relocate(Span(*this)[{ .start = end }], Span(*this)[{ .start = start }]);
+		m_count -= static_cast<size_type>(end - start);
+	}
+
+	/// @}
+
+private:
+	detail::inplace_storage<T, Capacity> m_storage;
+	size_type m_count = 0;
+
+	constexpr auto as_raw_span() -> Span<T> { return Span(this->data(), Capacity); }
+};
+
+} // namespace bpl
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <bpl/allocator.hpp>
 #include <bpl/memory.hpp>
 #include <bpl/span.hpp>
 #include <bpl/tags.hpp>
@@ -90,7 +91,10 @@ private:
 };
 
 /// A singly linked list.
-template<typename T>
+///
+/// Nodes are allocated from `A` in batches, so building a list of `n` elements calls the allocator about `n / 64`
+/// times when `A` is a `BatchAllocator`.
+template<typename T, Allocator A = GlobalAllocator>
 class LinkedList {
 public:
 	/// @name Special member functions
@@ -101,50 +105,52 @@ public:
 	LinkedList(LinkedList&) = delete;
 	auto operator=(LinkedList&) -> LinkedList = delete;
 
-	LinkedList(LinkedList&& other) noexcept : m_head(std::exchange(other.m_head, nullptr)) {}
+	LinkedList(LinkedList&& other) noexcept
+		: m_head(std::exchange(other.m_head, nullptr)),
+		  m_node_size(other.m_node_size),
+		  m_allocator(std::move(other.m_allocator)) {}
 	auto operator=(LinkedList&& rhs) noexcept -> LinkedList& {
-		m_head = std::exchange(rhs.m_head, nullptr);
+		if (this != &rhs) {
+			this->destroy_nodes();
+			m_head = std::exchange(rhs.m_head, nullptr);
+			m_node_size = rhs.m_node_size;
+			m_allocator = std::move(rhs.m_allocator);
+		}
 		return *this;
 	}
 
-	~LinkedList() {
-		LinkedListNode<T>* node = m_head;
-		while (node != nullptr) {
-			delete std::exchange(node, node->next);
-		}
-	}
+	~LinkedList() { this->destroy_nodes(); }
 
 	/// @}
 
 	/// @name Constructors
 	/// @{
 
+	/// Creates an empty linked list with a custom allocator.
+	explicit LinkedList(A&& allocator) : m_allocator(std::move(allocator)) {}
+
 	/// @{
 	/// Create a linked list with `count` elements constructed in-place.
 	template<typename... Args>
-	explicit LinkedList(size_t count, Args&&... args) {
-		if (count == 0) {
-			return;
-		}
-		m_head = make_node(in_place, std::forward<Args>(args)...);
-		LinkedListNode<T>* node = m_head;
-		for (size_t i = 1; i < count; ++i) {
-			node->next = make_node(in_place, std::forward<Args>(args)...);
-			node = node->next;
-		}
+	explicit LinkedList(size_t count, Args&&... args) : LinkedList(A{}, count, std::forward<Args>(args)...) {}
+	template<typename... Args>
+	explicit LinkedList(A&& allocator, size_t count, Args&&... args) : m_allocator(std::move(allocator)) {
+		LinkedListNode<T>** link = &m_head;
+		detail::allocate_nodes<LinkedListNode<T>>(m_allocator, count, m_node_size, [&](void* ptr) {
+			*link = ::new (ptr) LinkedListNode<T>(in_place, args...);
+			link = &(*link)->next;
+		});
 	}
 	/// @}
 
-	explicit LinkedList(T* data, size_t count) {
-		if (count == 0) {
-			return;
-		}
-		m_head = make_node(in_place, *data);
-		LinkedListNode<T>* node = m_head;
-		for (const auto& element : make_sized_range(data + 1, count - 1)) {
-			node->next = make_node(in_place, element);
-			node = node->next;
-		}
+	explicit LinkedList(T* data, size_t count) : LinkedList(A{}, data, count) {}
+	explicit LinkedList(A&& allocator, T* data, size_t count) : m_allocator(std::move(allocator)) {
+		LinkedListNode<T>** link = &m_head;
+		detail::allocate_nodes<LinkedListNode<T>>(m_allocator, count, m_node_size, [&](void* ptr) {
+			*link = ::new (ptr) LinkedListNode<T>(in_place, *data);
+			link = &(*link)->next;
+			data += 1;
+		});
 	}
 
 	explicit LinkedList(Span<T> span) : LinkedList(span.data(), span.size()) {}
@@ -156,6 +162,9 @@ public:
 
 	static auto alignment() -> size_t { return alignof(LinkedListNode<T>); }
 
+	/// Returns a const reference to the allocator.
+	auto allocator() const -> const A& { return m_allocator; }
+
 	/// @}
 
 	/// @name Iterators
@@ -171,10 +180,17 @@ public:
 
 private:
 	LinkedListNode<T>* m_head = nullptr;
+	// The size of the blocks returned by the allocator for each node
+	size_t m_node_size = sizeof(LinkedListNode<T>);
+	[[no_unique_address]] A m_allocator{};
 
-	template<typename... Args>
-	auto make_node(Args&&... args) -> LinkedListNode<T>* {
-		return ::new LinkedListNode<T>(std::forward<Args>(args)...);
+	void destroy_nodes() {
+		detail::NodeDeallocator<LinkedListNode<T>, A> deallocator(m_allocator, m_node_size);
+		LinkedListNode<T>* node = m_head;
+		while (node != nullptr) {
+			deallocator.push(std::exchange(node, node->next));
+		}
+		m_head = nullptr;
 	}
 };
 
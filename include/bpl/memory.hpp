@@ -8,9 +8,12 @@
 
 #include <bpl/assert.hpp>
 #include <bpl/bit.hpp>
+#include <bpl/math.hpp>
 #include <bpl/ptr.hpp>
 #include <bpl/ranges.hpp>
+#include <bpl/traits.hpp>
 
+#include <concepts>
 #include <limits>
 #include <memory>
 #include <type_traits>
@@ -18,6 +21,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 namespace bpl {
 
@@ -67,6 +71,31 @@ constexpr auto align_ptr_forward(T* ptr, size_t alignment) -> T* {
 	return ptr + distance;
 }
 
+namespace detail {
+
+// `src` and `dst` are contiguous ranges of the same type, whose elements can be moved with `memmove`.
+template<typename R1, typename R2>
+concept memmove_relocatable = bpl::contiguous_range<R1> && bpl::contiguous_range<R2>
+	&& std::same_as<std::remove_cv_t<bpl::range_value_t<R1>>, bpl::range_value_t<R2>>
+	&& bpl::trivially_relocatable<bpl::range_value_t<R2>>;
+
+// `src` and `dst` are contiguous ranges of the same type, whose elements can be copied with `memmove`.
+template<typename R1, typename R2>
+concept memmove_copyable = bpl::contiguous_range<R1> && bpl::contiguous_range<R2>
+	&& std::same_as<std::remove_cv_t<bpl::range_value_t<R1>>, bpl::range_value_t<R2>>
+	&& bpl::trivially_copyable<bpl::range_value_t<R2>>;
+
+// Moves `count` objects of type `T` from `src` to `dst`, which may overlap.
+template<typename T>
+inline void memmove_n(T* dst, const T* src, size_t count) {
+	if (count != 0) {
+		// Casting to `void*` tells the compiler that we know that `T` might not be trivially copyable.
+		std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+	}
+}
+
+} // namespace detail
+
 template<typename T>
 constexpr void default_construct_at(T* ptr) {
 	::new (ptr) T;
@@ -82,8 +111,22 @@ constexpr auto construct(R&& range, Args&&... args) -> size_t {
 	return count;
 }
 
+/// Relocates the elements from `src` to the uninitialized memory area `dst`, front to back.
+///
+/// Trivially relocatable elements are relocated with a single `memmove`.
+///
+/// @note `src` and `dst` may overlap only if `dst` begins before `src`.
+///
+/// @returns The number of elements relocated.
 template<bpl::range R1, bpl::range R2>
 constexpr auto relocate(R1&& src, R2&& dst) -> size_t {
+	if constexpr (detail::memmove_relocatable<R1, R2>) {
+		if (!std::is_constant_evaluated()) {
+			size_t count = bpl::min(static_cast<size_t>(bpl::size(src)), static_cast<size_t>(bpl::size(dst)));
+			detail::memmove_n(bpl::data(dst), bpl::data(src), count);
+			return count;
+		}
+	}
 	size_t count = 0;
 	auto src_it = bpl::begin(src);
 	auto dst_it = bpl::begin(dst);
@@ -94,10 +137,26 @@ constexpr auto relocate(R1&& src, R2&& dst) -> size_t {
 	return count;
 }
 
+/// Relocates the elements from `src` to the end of the uninitialized memory area `dst`, back to front.
+///
+/// Trivially relocatable elements are relocated with a single `memmove`.
+///
+/// @note `src` and `dst` may overlap only if `dst` ends after `src`.
+///
+/// @pre
+///   - `size(src) <= size(dst)`.
+///
+/// @returns The number of elements relocated.
 template<bpl::random_access_range R1, bpl::random_access_range R2>
 constexpr auto relocate_backward(R1&& src, R2&& dst) -> size_t {
 	BPL_DEBUG_ASSERT(bpl::size(src) <= bpl::size(dst));
 	size_t count = bpl::size(src);
+	if constexpr (detail::memmove_relocatable<R1, R2>) {
+		if (!std::is_constant_evaluated()) {
+			detail::memmove_n(bpl::data(dst) + (bpl::size(dst) - count), bpl::data(src), count);
+			return count;
+		}
+	}
 	size_t src_index = bpl::size(src) - 1;
 	size_t dst_index = bpl::size(dst) - 1;
 	for (size_t i = 0; i < count; ++i) {
@@ -133,6 +192,12 @@ constexpr auto uninitialized_copy(R1&& src, R2&& dst) -> size_t {
 	if constexpr (bpl::sized_range<R1> && bpl::sized_range<R2>) {
 		BPL_DEBUG_ASSERT(bpl::size(src) <= bpl::size(dst));
 	}
+	if constexpr (detail::memmove_copyable<R1, R2>) {
+		if (!std::is_constant_evaluated()) {
+			detail::memmove_n(bpl::data(dst), bpl::data(src), bpl::size(src));
+			return bpl::size(src);
+		}
+	}
 	size_t count = 0;
 	{
 		auto src_it = bpl::begin(src);
@@ -155,6 +220,12 @@ constexpr auto uninitialized_move(R1&& src, R2&& dst) -> size_t {
 	if constexpr (bpl::sized_range<R1> && bpl::sized_range<R2>) {
 		BPL_DEBUG_ASSERT(bpl::size(src) <= bpl::size(dst));
 	}
+	if constexpr (detail::memmove_copyable<R1, R2>) {
+		if (!std::is_constant_evaluated()) {
+			detail::memmove_n(bpl::data(dst), bpl::data(src), bpl::size(src));
+			return bpl::size(src);
+		}
+	}
 	size_t count = 0;
 	{
 		auto src_it = bpl::begin(src);
@@ -15,6 +15,7 @@
 #endif
 
 #include <cstddef>
+#include <cstdint>
 
 namespace bpl {
 
@@ -45,14 +46,83 @@ inline auto get_page_size() -> size_t {
 	return page_size;
 }
 
+/// Returns the size of a huge page in bytes, or the size of a page if the OS doesn't support huge pages.
+///
+/// On Linux, it's the size of the transparent huge pages, which is also the default size of explicit huge pages on
+/// the common architectures (2 MiB on x86-64).
+///
+/// @note The value is retrieved once and then cached.
+[[nodiscard]]
+auto get_huge_page_size() -> size_t;
+
+/// The kind of pages that back a block of reserved memory.
+enum class HugePages : uint8_t {
+	/// Pages of `get_page_size()` bytes.
+	none,
+	/// Transparent huge pages: the block is aligned to `get_huge_page_size()` and advised with `MADV_HUGEPAGE`, so
+	/// that the OS backs it with huge pages when it can.
+	transparent,
+	/// Explicit huge pages from the pool configured by the administrator (`MAP_HUGETLB`), or transparent huge pages if
+	/// the pool doesn't have enough free pages. Explicit huge pages can only be committed, decommitted and released
+	/// in multiples of `get_huge_page_size()` bytes.
+	hugetlb,
+};
+
+/// How the pages of a block of memory are placed on the NUMA nodes of the machine.
+enum class NumaMode : uint8_t {
+	/// The policy of the thread, which by default places each page on the node of the CPU that first touches it.
+	none,
+	/// Pages are placed only on `NumaPolicy::node`.
+	bind,
+	/// Pages are placed on all the nodes, round-robin, to spread the bandwidth of memory shared by many threads.
+	interleave,
+	/// Pages are placed on `NumaPolicy::node` when it has free memory, and on other nodes otherwise.
+	preferred,
+	/// Like `preferred`, on the node of the CPU that sets the policy.
+	preferred_local,
+};
+
+/// A NUMA memory policy, applied to a block of memory with `try_set_numa_policy`.
+struct NumaPolicy {
+	NumaMode mode = NumaMode::none;
+	/// The node of the `bind` and `preferred` modes.
+	uint32_t node = 0;
+};
+
+/// Returns the number of NUMA nodes of the machine, `1` if it isn't a NUMA machine or the OS doesn't support NUMA.
+///
+/// @note The value is retrieved once and then cached.
+[[nodiscard]]
+auto get_numa_node_count() -> uint32_t;
+
+/// Returns the NUMA node of the CPU that runs the calling thread, `0` if the OS doesn't support NUMA.
+///
+/// The thread can be moved to another CPU at any time, unless it's pinned to the CPUs of a node.
+[[nodiscard]]
+auto get_current_numa_node() -> uint32_t;
+
+/// Tries to set the NUMA policy of a block of reserved memory, which applies to the pages that aren't placed yet.
+///
+/// On Linux, the policy is set with `mbind`. It does nothing on a machine with a single node.
+///
+/// @pre
+///   - `policy.node < get_numa_node_count()`, for the `bind` and `preferred` modes.
+///
+/// @returns `true` if successful.
+[[nodiscard]]
+auto try_set_numa_policy(MemoryBlock block, NumaPolicy policy) -> bool;
+
 /// Tries to allocate enough pages to fit `size` bytes, aborting if the operation fails.
 ///
+/// With huge pages, the size and the address of the block are multiples of `get_huge_page_size()`. The NUMA policy is
+/// applied on a best-effort basis: if the OS refuses it, the block keeps the policy of the thread.
+///
 /// @pre
 ///   - `bytes > 0`.
 ///
 /// @returns A `MemoryBlock` containing the allocated pages.
 [[nodiscard]]
-auto reserve_memory(size_t size) -> MemoryBlock;
+auto reserve_memory(size_t size, HugePages huge_pages = HugePages::none, NumaPolicy numa = {}) -> MemoryBlock;
 
 /// Tries to commit a previously reserved block of memory.
 ///
@@ -66,6 +136,51 @@ auto try_commit_memory(MemoryBlock block) -> bool;
 [[nodiscard]]
 auto try_decommit_memory(MemoryBlock block) -> bool;
 
+/// Touches every page of a block of committed memory, so that the OS backs it with physical memory before it's used.
+///
+/// Otherwise, the first access to each page takes a page fault. On Linux, the pages are populated with a single call
+/// to `madvise(MADV_POPULATE_WRITE)`, or by writing to each page if the kernel doesn't support it. The content of the
+/// block is preserved.
+///
+/// @pre
+///   - `block` has been entirely committed.
+void prefault_memory(MemoryBlock block);
+
+/// A hint about how a block of memory will be used, given to the OS with `try_advise_memory`.
+enum class MemoryAdvice : uint8_t {
+	/// The pages will be accessed sequentially, so the OS can read ahead aggressively.
+	sequential,
+	/// The pages will be accessed in random order, so reading ahead is useless.
+	random,
+	/// The pages will be accessed soon.
+	willneed,
+	/// The pages won't be accessed soon: the OS frees them now, and they are zero-filled when they're accessed again.
+	dontneed,
+	/// The content of the pages isn't needed anymore: the OS frees them lazily, when it's low on memory. Until then,
+	/// the pages keep their content, and writing to a page cancels the freeing of that page.
+	free,
+};
+
+/// Tries to give the OS a hint about how `block` will be used.
+///
+/// @returns `true` if successful.
+[[nodiscard]]
+auto try_advise_memory(MemoryBlock block, MemoryAdvice advice) -> bool;
+
+/// Tries to resize a block of committed memory to fit `new_size` bytes, moving it to a different address if needed.
+///
+/// The content of the block is preserved, up to the smaller of the two sizes, without being copied: on Linux, the
+/// pages are moved by remapping them with `mremap`. The new pages have the same protection as the old ones.
+///
+/// @pre
+///   - `block` was returned by `reserve_memory` or `try_remap_memory`, and it has been entirely committed.
+///   - `new_size > 0`.
+///
+/// @returns The resized block, or an empty block if the operation failed or isn't supported on this platform. On
+/// failure, `block` is left untouched.
+[[nodiscard]]
+auto try_remap_memory(MemoryBlock block, size_t new_size) -> MemoryBlock;
+
 /// Tries to release a block of memory.
 ///
 /// @returns `true` if successful.
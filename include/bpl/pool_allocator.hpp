@@ -0,0 +1,258 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// An allocator of fixed-size blocks.
+
+#include <bpl/allocator.hpp>
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/literals.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ptr.hpp>
+
+#include <new>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bpl {
+
+namespace detail {
+
+// A free block of a pool, which stores the next free block in its own memory.
+struct PoolFreeBlock {
+	PoolFreeBlock* next;
+};
+
+// Header at the beginning of each slab of a pool.
+struct PoolSlab {
+	// The whole slab, including this header
+	MemoryBlock block;
+	PoolSlab* next;
+};
+
+} // namespace detail
+
+/// An allocator of blocks of `BlockSize` bytes aligned to `Alignment`, with constant time allocation and deallocation.
+///
+/// Blocks are carved from slabs allocated from `Upstream`, and deallocated blocks are recycled through an intrusive
+/// free list. Slabs are returned to `Upstream` only by `release()` or when the pool is destroyed.
+///
+/// @tparam BlockSize The size of each block, which is rounded up to fit a pointer.
+/// @tparam Alignment The alignment of each block, a power of 2.
+/// @tparam Upstream The allocator of the slabs.
+template<size_t BlockSize, size_t Alignment = alignof(std::max_align_t), Allocator Upstream = GlobalAllocator>
+class PoolAllocator {
+	static_assert(BlockSize > 0);
+	static_assert(is_pow2(Alignment), "The alignment must be a power of 2.");
+
+public:
+	/// The alignment of each block.
+	static constexpr size_t block_alignment = bpl::max(Alignment, alignof(detail::PoolFreeBlock));
+
+	/// The size of each block, in bytes.
+	static constexpr size_t block_size =
+		align_forward(bpl::max(BlockSize, sizeof(detail::PoolFreeBlock)), block_alignment);
+
+	/// The default number of blocks in each slab, so that slabs are about 64 KiB.
+	static constexpr size_t default_blocks_per_slab = bpl::max(64_KiB / block_size, size_t{ 1 });
+
+	//////////////////////////////////////////////////
+	/// @name Special member functions
+	/// @{
+
+	/// Creates an empty pool.
+	PoolAllocator() = default;
+
+	PoolAllocator(const PoolAllocator&) = delete;
+	auto operator=(const PoolAllocator&) -> PoolAllocator& = delete;
+
+	PoolAllocator(PoolAllocator&& other) noexcept
+		: m_free(std::exchange(other.m_free, nullptr)),
+		  m_slabs(std::exchange(other.m_slabs, nullptr)),
+		  m_next(std::exchange(other.m_next, 0)),
+		  m_end(std::exchange(other.m_end, 0)),
+		  m_blocks_per_slab(other.m_blocks_per_slab),
+		  m_upstream(std::move(other.m_upstream)) {}
+	auto operator=(PoolAllocator&& other) noexcept -> PoolAllocator& {
+		if (this != &other) {
+			this->release();
+			m_free = std::exchange(other.m_free, nullptr);
+			m_slabs = std::exchange(other.m_slabs, nullptr);
+			m_next = std::exchange(other.m_next, 0);
+			m_end = std::exchange(other.m_end, 0);
+			m_blocks_per_slab = other.m_blocks_per_slab;
+			m_upstream = std::move(other.m_upstream);
+		}
+		return *this;
+	}
+
+	~PoolAllocator() { this->release(); }
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Constructors
+	/// @{
+
+	/// Creates an empty pool whose slabs have `blocks_per_slab` blocks.
+	///
+	/// @pre
+	///   - `blocks_per_slab > 0`
+	explicit PoolAllocator(size_t blocks_per_slab) : m_blocks_per_slab(blocks_per_slab) {
+		BPL_ASSERT(blocks_per_slab > 0);
+	}
+
+	/// Creates an empty pool whose slabs are allocated from `upstream`.
+	///
+	/// @pre
+	///   - `blocks_per_slab > 0`
+	explicit PoolAllocator(Upstream&& upstream, size_t blocks_per_slab = default_blocks_per_slab)
+		: m_blocks_per_slab(blocks_per_slab),
+		  m_upstream(std::move(upstream)) {
+		BPL_ASSERT(blocks_per_slab > 0);
+	}
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Inspection
+	/// @{
+
+	/// Returns the number of blocks in each slab.
+	[[nodiscard]]
+	auto blocks_per_slab() const -> size_t {
+		return m_blocks_per_slab;
+	}
+
+	/// Returns a const reference to the upstream allocator.
+	[[nodiscard]]
+	auto upstream() const -> const Upstream& {
+		return m_upstream;
+	}
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Methods
+	/// @{
+
+	/// Returns all the slabs to the upstream allocator, deallocating every block at once.
+	void release() {
+		while (m_slabs != nullptr) {
+			MemoryBlock slab = m_slabs->block;
+			m_slabs = m_slabs->next;
+			m_upstream.deallocate(slab, slab_alignment);
+		}
+		m_free = nullptr;
+		m_next = 0;
+		m_end = 0;
+	}
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	/// Allocates a block.
+	///
+	/// @returns A block of `block_size` bytes, or an empty block if `size > block_size` or `alignment > block_alignment`.
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		if (size > block_size || alignment > block_alignment) {
+			return {};
+		}
+		if (m_free != nullptr) {
+			void* ptr = std::exchange(m_free, m_free->next);
+			return { .ptr = ptr, .size = block_size };
+		}
+		if (m_next == m_end && !this->add_slab()) {
+			return {};
+		}
+		void* ptr = addr_to_ptr<void>(std::exchange(m_next, m_next + block_size));
+		return { .ptr = ptr, .size = block_size };
+	}
+
+	/// Puts `block` back in the pool.
+	///
+	/// @pre
+	///   - `block` was allocated by this pool.
+	void deallocate(MemoryBlock block, size_t /*alignment*/) {
+		BPL_DEBUG_ASSERT(block.size == block_size);
+		m_free = ::new (block.ptr) detail::PoolFreeBlock{ .next = m_free };
+	}
+
+	/// Allocates `count` blocks, taking them from the free list first and then carving them from the current slab.
+	///
+	/// @returns `false` if `size > block_size`, `alignment > block_alignment` or a slab couldn't be allocated; in that
+	/// case no block is allocated.
+	[[nodiscard]]
+	auto allocate_batch(size_t size, size_t alignment, size_t count, MemoryBlock* blocks) -> bool {
+		if (size > block_size || alignment > block_alignment) {
+			return false;
+		}
+		size_t i = 0;
+		for (; i < count && m_free != nullptr; ++i) {
+			blocks[i] = { .ptr = std::exchange(m_free, m_free->next), .size = block_size };
+		}
+		while (i < count) {
+			if (m_next == m_end && !this->add_slab()) {
+				this->deallocate_batch(blocks, i, alignment);
+				return false;
+			}
+			const size_t carved = bpl::min(count - i, (m_end - m_next) / block_size);
+			for (size_t j = 0; j < carved; ++j) {
+				blocks[i + j] = { .ptr = addr_to_ptr<void>(m_next + (j * block_size)), .size = block_size };
+			}
+			m_next += carved * block_size;
+			i += carved;
+		}
+		return true;
+	}
+
+	/// Puts `count` blocks back in the pool.
+	///
+	/// @pre
+	///   - The blocks were allocated by this pool.
+	void deallocate_batch(const MemoryBlock* blocks, size_t count, size_t alignment) {
+		for (size_t i = count; i > 0; --i) {
+			this->deallocate(blocks[i - 1], alignment);
+		}
+	}
+
+	/// @}
+
+private:
+	static constexpr size_t slab_alignment = bpl::max(block_alignment, alignof(detail::PoolSlab));
+	static constexpr size_t slab_header_size = align_forward(sizeof(detail::PoolSlab), block_alignment);
+
+	// The most recently deallocated block
+	detail::PoolFreeBlock* m_free = nullptr;
+	// The most recently allocated slab
+	detail::PoolSlab* m_slabs = nullptr;
+	// The part of the most recent slab that was never allocated
+	uintptr_t m_next = 0;
+	uintptr_t m_end = 0;
+	size_t m_blocks_per_slab = default_blocks_per_slab;
+	[[no_unique_address]] Upstream m_upstream{};
+
+	// Allocates a new slab, whose blocks are carved as they are allocated.
+	[[nodiscard]]
+	auto add_slab() -> bool {
+		MemoryBlock slab = m_upstream.allocate(slab_header_size + (m_blocks_per_slab * block_size), slab_alignment);
+		if (slab.ptr == nullptr) {
+			return false;
+		}
+		m_slabs = ::new (slab.ptr) detail::PoolSlab{ .block = slab, .next = m_slabs };
+		m_next = ptr_to_addr(slab.ptr) + slab_header_size;
+		m_end = m_next + (m_blocks_per_slab * block_size);
+		return true;
+	}
+};
+
+} // namespace bpl
@@ -0,0 +1,59 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// A general purpose allocator with size classes and per-thread caches.
+
+#include <bpl/literals.hpp>
+#include <bpl/memory.hpp>
+
+#include <cstddef>
+
+namespace bpl {
+
+/// A stateless general purpose allocator, which can replace `GlobalAllocator`.
+///
+/// Small blocks are rounded up to a power-of-2 size class and carved from slabs allocated with `PagesAllocator`.
+/// Each thread caches the free blocks of each size class, so most allocations and deallocations don't synchronize
+/// with other threads. When a cache grows too large, half of it moves to a depot shared by all threads with a
+/// lock-free push, and a thread whose cache is empty takes the whole depot at once. A block can be deallocated by any
+/// thread, because the size of the block is enough to find its size class.
+///
+/// Blocks larger than `max_small_size` bytes are allocated directly with `PagesAllocator`.
+///
+/// @note Slabs are never returned to the OS: the free blocks of a size class are only reused by that size class.
+struct SlabAllocator {
+	/// The smallest size class, in bytes.
+	static constexpr size_t min_small_size = 16;
+	/// The largest size class, in bytes.
+	static constexpr size_t max_small_size = 32_KiB;
+	/// The size of each slab, in bytes.
+	static constexpr size_t slab_size = 64_KiB;
+
+	/// @name Allocator API
+	/// @{
+
+	/// @pre
+	///   - `alignment` is a power of 2 less or equal to the page size
+	static auto allocate(size_t size, size_t alignment) -> MemoryBlock;
+
+	/// @pre
+	///   - `block` was returned by `allocate`, with the same size
+	static void deallocate(MemoryBlock block, size_t alignment);
+
+	/// Allocates `count` blocks, looking up the size class and the cache of the thread once.
+	///
+	/// @pre
+	///   - `alignment` is a power of 2 less or equal to the page size
+	static auto allocate_batch(size_t size, size_t alignment, size_t count, MemoryBlock* blocks) -> bool;
+
+	/// @pre
+	///   - The blocks were returned by `allocate` or `allocate_batch`, with the same size
+	static void deallocate_batch(const MemoryBlock* blocks, size_t count, size_t alignment);
+
+	/// @}
+};
+
+} // namespace bpl
@@ -0,0 +1,412 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <bpl/allocator.hpp>
+#include <bpl/assert.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ranges.hpp>
+#include <bpl/span.hpp>
+#include <bpl/tags.hpp>
+#include <bpl/traits.hpp>
+
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include <cstddef>
+
+namespace bpl {
+
+/// A dynamic array that stores up to `N` elements inline, and uses the allocator only when it grows beyond that.
+template<relocatable T, size_t N, Allocator A = GlobalAllocator>
+class SmallArray {
+	static_assert(N > 0, "Use Array for arrays without inline storage.");
+
+public:
+	/// @name Special member functions
+	/// @{
+
+	/// Constructs an empty dynamic array.
+	SmallArray() = default;
+
+	SmallArray(const SmallArray& other);
+	auto operator=(const SmallArray& other) -> SmallArray&;
+
+	SmallArray(SmallArray&& other) noexcept;
+	auto operator=(SmallArray&& other) noexcept -> SmallArray&;
+
+	~SmallArray();
+
+	/// @}
+
+	/// @name Constructors
+	/// @{
+
+	/// Constructs an empty dynamic array with a custom allocator.
+	explicit SmallArray(A&& allocator) : m_allocator(std::move(allocator)) {}
+
+	/// Constructs a dynamic array with `count` elements, constructed in-place.
+	template<typename... Args>
+	explicit SmallArray(size_t count, Args&&... args) : SmallArray(A{}, count, std::forward<Args>(args)...) {}
+	template<typename... Args>
+	explicit SmallArray(A&& allocator, size_t count, Args&&... args) : SmallArray(std::move(allocator)) {
+		this->append_n(count, std::forward<Args>(args)...);
+	}
+
+	/// Constructs a dynamic array by copying the elements from the range `r`.
+	template<range R>
+	explicit SmallArray(from_range_t, R&& r) : SmallArray(from_range, A{}, std::forward<R>(r)) {}
+	template<range R>
+	explicit SmallArray(from_range_t, A&& allocator, R&& r) : SmallArray(std::move(allocator)) {
+		this->append_range(std::forward<R>(r));
+	}
+
+	/// @}
+
+	/// @name Iterators
+	/// @{
+
+	/// Returns a pointer to the first element.
+	auto data() -> T* { return static_cast<T*>(m_block.ptr); }
+	auto data() const -> const T* { return static_cast<const T*>(m_block.ptr); }
+
+	/// Returns a pointer to the first element.
+	auto begin() -> T* { return this->data(); }
+	auto begin() const -> const T* { return this->data(); }
+
+	/// Returns a pointer to one past the last element.
+	auto end() -> T* { return this->data() + this->size(); }
+	auto end() const -> const T* { return this->data() + this->size(); }
+
+	/// @}
+
+	/// @name Element access
+	/// @{
+
+	/// Returns a reference to the element at `idx`.
+	///
+	/// @pre
+	///   - `idx` is not out-of-bounds.
+	auto operator[](size_t idx) -> T& { return Span(*this)[idx]; }
+	auto operator[](size_t idx) const -> const T& { return Span(*this)[idx]; }
+
+	/// Returns a reference to the element at `idx`.
+	///
+	/// Aborts if `idx` is out-of-bounds.
+	auto at(size_t idx) -> T& { return Span(*this).at(idx); }
+	auto at(size_t idx) const -> const T& { return Span(*this).at(idx); }
+
+	/// Returns a reference to the first element.
+	///
+	/// Aborts if the array is empty.
+	auto front() -> T& { return Span(*this).front(); }
+	auto front() const -> const T& { return Span(*this).front(); }
+
+	/// Returns a reference to the last element.
+	///
+	/// Aborts if the array is empty.
+	auto back() -> T& { return Span(*this).back(); }
+	auto back() const -> const T& { return Span(*this).back(); }
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the number of elements in the container.
+	auto size() const -> size_t { return m_count; }
+
+	/// Returns the size of the array in bytes.
+	auto size_bytes() const -> size_t { return this->size() * sizeof(T); }
+
+	/// Returns `true` if the container has no elements.
+	auto empty() const -> bool { return this->size() == 0; }
+
+	/// Returns the number of elements that can be stored without allocating.
+	auto capacity() const -> size_t { return m_block.size / sizeof(T); }
+
+	/// Returns the number of elements that can be stored inline.
+	static constexpr auto inline_capacity() -> size_t { return N; }
+
+	/// Returns `true` if the elements are stored inline.
+	auto is_inline() const -> bool { return m_block.ptr == m_storage; }
+
+	/// Returns the alignment of the block of memory.
+	auto alignment() const -> size_t { return alignof(T); }
+
+	/// Returns a const reference to the underlying allocator.
+	auto allocator() const -> const A& { return m_allocator; }
+
+	/// @}
+
+	/// @name Modifiers
+	/// @{
+
+	/// Increases capacity of the container to fit at least `count` elements.
+	void reserve(size_t count);
+
+	/// Moves the elements back inline if they fit, otherwise reduces the capacity of the container to fit them.
+	void shrink_to_fit();
+
+	/// Destroys all elements in the array.
+	void clear();
+
+	/// Resizes array to contain `count` elements, constructing new elements in-place.
+	template<typename... Args>
+	void resize(size_t count, Args&&... args);
+
+	/// Appends a new value in-place.
+	template<typename... Args>
+	void append(Args&&... args);
+
+	/// Appends `n` new values in-place.
+	template<typename... Args>
+	void append_n(size_t n, Args&&... args);
+
+	/// Appends elements from `range`, one at a time.
+	template<range R>
+	void append_range(R&& range);
+
+	/// Appends elements from `range`.
+	template<sized_range R>
+	void append_range(R&& range);
+
+	/// Inserts an element before `idx`, in-place.
+	template<typename... Args>
+	void insert(size_t idx, Args&&... args);
+
+	/// Inserts the elements from `range` before `idx`.
+	template<sized_range R>
+	void insert_range(size_t idx, R&& range);
+
+	/// Erases and returns the element at `idx`.
+	///
+	/// @pre
+	///   - `idx < size()`
+	auto remove(size_t idx) -> T;
+
+	/// Erases the elements in `[ start, end )`.
+	///
+	/// @pre
+	///   - `start <= end`
+	///   - `end <= size()`
+	void remove(size_t start, size_t end);
+
+	/// @}
+
+private:
+	MemoryBlock m_block = { .ptr = m_storage, .size = sizeof(m_storage) };
+	size_t m_count = 0;
+	[[no_unique_address]] A m_allocator{};
+	alignas(T) std::byte m_storage[N * sizeof(T)];
+
+	auto as_raw_span() -> Span<T> { return Span(this->data(), this->capacity()); }
+
+	// Grows the capacity geometrically to fit at least `count` elements.
+	void grow(size_t count) {
+		if (count > this->capacity()) {
+			this->reserve(bpl::max(count, this->capacity() * 2));
+		}
+	}
+
+	// Relocates the elements to `block` and releases the current block.
+	void relocate_to(MemoryBlock block) {
+		relocate(*this, Span<T>(static_cast<T*>(block.ptr), block.size / sizeof(T)));
+		this->deallocate();
+		m_block = block;
+	}
+
+	// Releases the block if it was allocated, and makes the array use the inline storage.
+	void deallocate() {
+		if (!this->is_inline()) {
+			m_allocator.deallocate(m_block, this->alignment());
+			m_block = { .ptr = m_storage, .size = sizeof(m_storage) };
+		}
+	}
+
+	// Takes the elements of `other`, leaving it empty.
+	void take(SmallArray& other) {
+		if (other.is_inline()) {
+			relocate(other, this->as_raw_span());
+		} else {
+			m_block = std::exchange(other.m_block, { .ptr = other.m_storage, .size = sizeof(other.m_storage) });
+		}
+		m_count = std::exchange(other.m_count, 0);
+	}
+};
+
+template<relocatable T, size_t N, Allocator A>
+SmallArray<T, N, A>::SmallArray(const SmallArray& other) : SmallArray(from_range, other) {
+}
+
+template<relocatable T, size_t N, Allocator A>
+auto SmallArray<T, N, A>::operator=(const SmallArray& other) -> SmallArray<T, N, A>& {
+	if (this == &other) {
+		return *this;
+	}
+	this->clear();
+	this->append_range(other);
+	return *this;
+}
+
+template<relocatable T, size_t N, Allocator A>
+SmallArray<T, N, A>::SmallArray(SmallArray&& other) noexcept : m_allocator(std::move(other.m_allocator)) {
+	this->take(other);
+}
+
+template<relocatable T, size_t N, Allocator A>
+auto SmallArray<T, N, A>::operator=(SmallArray&& other) noexcept -> SmallArray<T, N, A>& {
+	if (this == &other) {
+		return *this;
+	}
+	this->clear();
+	this->deallocate();
+	m_allocator = std::move(other.m_allocator);
+	this->take(other);
+	return *this;
+}
+
+template<relocatable T, size_t N, Allocator A>
+SmallArray<T, N, A>::~SmallArray() {
+	this->clear();
+	this->deallocate();
+}
+
+template<relocatable T, size_t N, Allocator A>
+void SmallArray<T, N, A>::reserve(size_t count) {
+	if (count <= this->capacity()) {
+		return;
+	}
+	BPL_DEBUG_ASSERT(count <= std::numeric_limits<size_t>::max() / sizeof(T));
+	if constexpr (GrowableAllocator<A>) {
+		if (!this->is_inline()) {
+			MemoryBlock grown_block =
+				m_allocator.try_grow(m_block, this->alignment(), count * sizeof(T) - m_block.size);
+			if (grown_block.ptr != nullptr) {
+				m_block = grown_block;
+				return;
+			}
+		}
+	}
+	this->relocate_to(m_allocator.allocate(count * sizeof(T), this->alignment()));
+}
+
+template<relocatable T, size_t N, Allocator A>
+void SmallArray<T, N, A>::shrink_to_fit() {
+	if (this->is_inline() || this->capacity() == this->size()) {
+		return;
+	}
+	if (this->size() <= N) {
+		MemoryBlock block = m_block;
+		relocate(*this, Span(reinterpret_cast<T*>(m_storage), N));
+		m_allocator.deallocate(block, this->alignment());
+		m_block = { .ptr = m_storage, .size = sizeof(m_storage) };
+		return;
+	}
+	if constexpr (ShrinkableAllocator<A>) {
+		if (m_allocator.try_shrink(m_block, this->alignment(), this->size_bytes())) {
+			m_block.size = this->size_bytes();
+		}
+	} else {
+		MemoryBlock new_block = m_allocator.allocate(this->size_bytes(), this->alignment());
+		if (new_block.size >= m_block.size) {
+			m_allocator.deallocate(new_block, this->alignment());
+			return;
+		}
+		this->relocate_to(new_block);
+	}
+}
+
+template<relocatable T, size_t N, Allocator A>
+void SmallArray<T, N, A>::clear() {
+	destroy_backward(*this);
+	m_count = 0;
+}
+
+template<relocatable T, size_t N, Allocator A>
+template<typename... Args>
+void SmallArray<T, N, A>::resize(size_t count, Args&&... args) {
+	if (count > this->size()) {
+		this->reserve(count);
+		construct(this->as_raw_span()[{ .start = this->size(), .end = count }], std::forward<Args>(args)...);
+	} else if (count < this->size()) {
+		destroy_backward(Span(*this)[{ .start = count }]);
+	}
+	m_count = count;
+}
+
+template<relocatable T, size_t N, Allocator A>
+template<typename... Args>
+void SmallArray<T, N, A>::append(Args&&... args) {
+	this->grow(this->size() + 1);
+	std::construct_at(this->end(), std::forward<Args>(args)...);
+	m_count += 1;
+}
+
+template<relocatable T, size_t N, Allocator A>
+template<typename... Args>
+void SmallArray<T, N, A>::append_n(size_t n, Args&&... args) {
+	this->grow(this->size() + n);
+	m_count += construct(this->as_raw_span()[{ .start = this->size(), .count = n }], std::forward<Args>(args)...);
+}
+
+template<relocatable T, size_t N, Allocator A>
+template<range R>
+void SmallArray<T, N, A>::append_range(R&& range) {
+	for (const auto& element : range) {
+		this->append(element);
+	}
+}
+
+template<relocatable T, size_t N, Allocator A>
+template<sized_range R>
+void SmallArray<T, N, A>::append_range(R&& range) {
+	this->grow(this->size() + bpl::size(range));
+	m_count += uninitialized_copy(range, this->as_raw_span()[{ .start = this->size() }]);
+}
+
+template<relocatable T, size_t N, Allocator A>
+template<typename... Args>
+void SmallArray<T, N, A>::insert(size_t idx, Args&&... args) {
+	BPL_ASSERT(idx <= this->size());
+	this->grow(this->size() + 1);
+	relocate_backward(Span(*this)[{ .start = idx }], this->as_raw_span()[{ .end = this->size() + 1 }]);
+	std::construct_at(this->data() + idx, std::forward<Args>(args)...);
+	m_count += 1;
+}
+
+template<relocatable T, size_t N, Allocator A>
+template<sized_range R>
+void SmallArray<T, N, A>::insert_range(size_t idx, R&& range) {
+	BPL_ASSERT(idx <= this->size());
+	if (bpl::size(range) == 0) {
+		return;
+	}
+	this->grow(this->size() + bpl::size(range));
+	relocate_backward(Span(*this)[{ .start = idx }], this->as_raw_span()[{ .end = this->size() + bpl::size(range) }]);
+	m_count += uninitialized_copy(range, this->as_raw_span()[{ .start = idx }]);
+}
+
+template<relocatable T, size_t N, Allocator A>
+auto SmallArray<T, N, A>::remove(size_t idx) -> T {
+	BPL_ASSERT(idx < this->size());
+	T x = std::move(this->operator[](idx));
+	std::destroy_at(std::addressof(this->operator[](idx)));
+	relocate(Span(*this)[{ .start = idx + 1 }], Span(*this)[{ .start = idx }]);
+	m_count -= 1;
+	return x;
+}
+
+template<relocatable T, size_t N, Allocator A>
+void SmallArray<T, N, A>::remove(size_t start, size_t end) {
+	BPL_DEBUG_ASSERT(start <= end);
+	BPL_DEBUG_ASSERT(end <= this->size());
+	destroy_backward(Span(*this)[{ .start = start, .end = end }]);
+	relocate(Span(*this)[{ .start = end }], Span(*this)[{ .start = start }]);
+	m_count -= end - start;
+}
+
+} // namespace bpl
@@ -0,0 +1,280 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// A dynamic array that stores each field of its elements in a separate column.
+
+#include <bpl/allocator.hpp>
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/growth.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/os.hpp>
+#include <bpl/span.hpp>
+#include <bpl/traits.hpp>
+
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include <cstddef>
+
+namespace bpl {
+
+/// A dynamic array of records stored as a structure of arrays: one column per field, all in one block of memory.
+///
+/// Each column begins at a multiple of `CACHE_LINE_SIZE`, so that loops over a single column touch only the bytes of
+/// that field and can be vectorized.
+///
+/// @tparam A The allocator.
+/// @tparam G Computes the new capacity when records are added to a full array.
+/// @tparam Ts The types of the fields.
+template<Allocator A, GrowthPolicy G, relocatable... Ts>
+class BasicSoAArray {
+	static_assert(sizeof...(Ts) > 0);
+
+public:
+	/// @name Types
+	/// @{
+
+	/// The type of the `I`-th column.
+	template<size_t I>
+	using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+	/// @}
+
+	/// @name Special member functions
+	/// @{
+
+	/// Constructs an empty array.
+	BasicSoAArray() = default;
+
+	BasicSoAArray(const BasicSoAArray&) = delete;
+	auto operator=(const BasicSoAArray&) -> BasicSoAArray& = delete;
+
+	BasicSoAArray(BasicSoAArray&& other) noexcept
+		: m_block(std::exchange(other.m_block, {})),
+		  m_count(std::exchange(other.m_count, 0)),
+		  m_capacity(std::exchange(other.m_capacity, 0)),
+		  m_allocator(std::move(other.m_allocator)) {}
+	auto operator=(BasicSoAArray&& other) noexcept -> BasicSoAArray& {
+		if (this != &other) {
+			this->clear();
+			this->deallocate();
+			m_block = std::exchange(other.m_block, {});
+			m_count = std::exchange(other.m_count, 0);
+			m_capacity = std::exchange(other.m_capacity, 0);
+			m_allocator = std::move(other.m_allocator);
+		}
+		return *this;
+	}
+
+	~BasicSoAArray() {
+		this->clear();
+		this->deallocate();
+	}
+
+	/// @}
+
+	/// @name Constructors
+	/// @{
+
+	/// Constructs an empty array with a custom allocator.
+	explicit BasicSoAArray(A&& allocator) : m_allocator(std::move(allocator)) {}
+
+	/// @}
+
+	/// @name Element access
+	/// @{
+
+	/// Returns the `I`-th column.
+	template<size_t I>
+	auto column() -> Span<column_type<I>> {
+		return Span(this->template column_data<I>(m_block.ptr, m_capacity), m_count);
+	}
+	template<size_t I>
+	auto column() const -> Span<const column_type<I>> {
+		return Span<const column_type<I>>(this->template column_data<I>(m_block.ptr, m_capacity), m_count);
+	}
+
+	/// @}
+
+	/// @name Inspection
+	/// @{
+
+	/// Returns the number of records.
+	auto size() const -> size_t { return m_count; }
+
+	/// Returns `true` if the array has no records.
+	auto empty() const -> bool { return this->size() == 0; }
+
+	/// Returns the number of records that can be stored in the currently allocated block of memory.
+	auto capacity() const -> size_t { return m_capacity; }
+
+	/// Returns the alignment of the block of memory, which is also the alignment of each column.
+	static constexpr auto alignment() -> size_t {
+		size_t result = CACHE_LINE_SIZE;
+		((result = bpl::max(result, alignof(Ts))), ...);
+		return result;
+	}
+
+	/// Returns a const reference to the underlying allocator.
+	auto allocator() const -> const A& { return m_allocator; }
+
+	/// @}
+
+	/// @name Modifiers
+	/// @{
+
+	/// Increases the capacity to fit at least `count` records.
+	void reserve(size_t count);
+
+	/// Destroys all records.
+	void clear();
+
+	/// Appends a record, constructing each field from the corresponding argument.
+	template<typename... Args>
+	requires (sizeof...(Args) == sizeof...(Ts))
+	void append(Args&&... args);
+
+	/// Erases the record at `idx`, preserving the order of the other records.
+	///
+	/// @pre
+	///   - `idx < size()`
+	void remove(size_t idx);
+
+	/// Erases the record at `idx`, replacing it with the last record.
+	///
+	/// @pre
+	///   - `idx < size()`
+	void swap_remove(size_t idx);
+
+	/// @}
+
+private:
+	static constexpr size_t column_count = sizeof...(Ts);
+
+	MemoryBlock m_block = {};
+	size_t m_count = 0;
+	size_t m_capacity = 0;
+	[[no_unique_address]] A m_allocator{};
+
+	// Returns the size of a column of `capacity` elements of type `T`, padded to the alignment of the next column.
+	template<typename T>
+	static auto column_bytes(size_t capacity) -> size_t {
+		BPL_DEBUG_ASSERT(capacity <= std::numeric_limits<size_t>::max() / sizeof(T));
+		return align_forward(capacity * sizeof(T), alignment());
+	}
+
+	// Returns the size of a block of memory that can hold `capacity` records.
+	static auto block_bytes(size_t capacity) -> size_t { return (column_bytes<Ts>(capacity) + ...); }
+
+	// Returns the largest capacity whose block fits in `bytes`, which is at least `block_bytes(min_capacity)`.
+	static auto capacity_for_bytes(size_t bytes, size_t min_capacity) -> size_t {
+		BPL_DEBUG_ASSERT(block_bytes(min_capacity) <= bytes);
+		// Without padding, the block of `bytes / record_size` records would fill `bytes` exactly
+		size_t low = min_capacity;
+		size_t high = bytes / (sizeof(Ts) + ...);
+		while (low < high) {
+			const size_t mid = high - ((high - low) / 2);
+			if (block_bytes(mid) <= bytes) {
+				low = mid;
+			} else {
+				high = mid - 1;
+			}
+		}
+		return low;
+	}
+
+	// Returns a pointer to the `I`-th column of a block of memory that can hold `capacity` records.
+	template<size_t I>
+	static auto column_data(void* block, size_t capacity) -> column_type<I>* {
+		return [&]<size_t... Is>(std::index_sequence<Is...>) {
+			size_t offset = (size_t{ 0 } + ... + column_bytes<column_type<Is>>(capacity));
+			return static_cast<column_type<I>*>(static_cast<void*>(static_cast<std::byte*>(block) + offset));
+		}(std::make_index_sequence<I>{});
+	}
+
+	template<typename F>
+	static void for_each_column(F&& f) {
+		[&]<size_t... Is>(std::index_sequence<Is...>) {
+			(f(std::integral_constant<size_t, Is>{}), ...);
+		}(std::make_index_sequence<column_count>{});
+	}
+
+	void deallocate() {
+		if (m_block.ptr != nullptr) {
+			m_allocator.deallocate(m_block, alignment());
+			m_block = {};
+			m_capacity = 0;
+		}
+	}
+};
+
+/// A structure of arrays that uses the global allocator and doubles its capacity when it's full.
+template<relocatable... Ts>
+using SoAArray = BasicSoAArray<GlobalAllocator, DoublingGrowth, Ts...>;
+
+template<Allocator A, GrowthPolicy G, relocatable... Ts>
+void BasicSoAArray<A, G, Ts...>::reserve(size_t count) {
+	if (count <= this->capacity()) {
+		return;
+	}
+	MemoryBlock new_block = m_allocator.allocate(block_bytes(count), alignment());
+	for_each_column([&]<size_t I>(std::integral_constant<size_t, I>) {
+		relocate(this->template column<I>(), Span(column_data<I>(new_block.ptr, count), count));
+	});
+	this->deallocate();
+	m_block = new_block;
+	m_capacity = count;
+}
+
+template<Allocator A, GrowthPolicy G, relocatable... Ts>
+void BasicSoAArray<A, G, Ts...>::clear() {
+	for_each_column([&]<size_t I>(std::integral_constant<size_t, I>) { destroy_backward(this->template column<I>()); });
+	m_count = 0;
+}
+
+template<Allocator A, GrowthPolicy G, relocatable... Ts>
+template<typename... Args>
+requires (sizeof...(Args) == sizeof...(Ts))
+void BasicSoAArray<A, G, Ts...>::append(Args&&... args) {
+	if (this->size() == this->capacity()) {
+		const size_t bytes = G::grow(block_bytes(this->capacity()), block_bytes(this->size() + 1));
+		this->reserve(capacity_for_bytes(bytes, this->size() + 1));
+	}
+	[&]<size_t... Is>(std::index_sequence<Is...>) {
+		(std::construct_at(column_data<Is>(m_block.ptr, m_capacity) + m_count, std::forward<Args>(args)), ...);
+	}(std::make_index_sequence<column_count>{});
+	m_count += 1;
+}
+
+template<Allocator A, GrowthPolicy G, relocatable... Ts>
+void BasicSoAArray<A, G, Ts...>::remove(size_t idx) {
+	BPL_ASSERT(idx < this->size());
+	for_each_column([&]<size_t I>(std::integral_constant<size_t, I>) {
+		auto column = this->template column<I>();
+		std::destroy_at(std::addressof(column[idx]));
+		relocate(column[{ .start = idx + 1 }], column[{ .start = idx }]);
+	});
+	m_count -= 1;
+}
+
+template<Allocator A, GrowthPolicy G, relocatable... Ts>
+void BasicSoAArray<A, G, Ts...>::swap_remove(size_t idx) {
+	BPL_ASSERT(idx < this->size());
+	for_each_column([&]<size_t I>(std::integral_constant<size_t, I>) {
+		auto column = this->template column<I>();
+		std::destroy_at(std::addressof(column[idx]));
+		if (idx != column.size() - 1) {
+			relocate(column[{ .start = column.size() - 1 }], column[{ .start = idx, .count = 1 }]);
+		}
+	});
+	m_count -= 1;
+}
+
+} // namespace bpl
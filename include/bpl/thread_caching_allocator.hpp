@@ -0,0 +1,236 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// A stateless allocator that caches small blocks in each thread.
+
+#include <bpl/allocator.hpp>
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/literals.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/os.hpp>
+
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bpl {
+
+/// A stateless allocator that keeps the small blocks deallocated by each thread, to reuse them without calling
+/// `Upstream`.
+///
+/// Small blocks are rounded up to a power-of-2 size class. Each thread has a list of free blocks for each size class;
+/// when a list grows longer than two batches of `batch_size` blocks, its least recently deallocated batch moves to a
+/// depot shared by all threads, and a thread whose list is empty takes a batch from the depot before calling
+/// `Upstream`. The depot keeps at most `max_depot_batches` batches for each size class, and gives the others back to
+/// `Upstream`. The depot is locked once per batch, so threads rarely contend. When a thread exits, its full batches
+/// move to the depot and its other blocks go back to `Upstream`.
+///
+/// Blocks larger than `max_cached_size` bytes are allocated directly from `Upstream`.
+///
+/// @tparam Upstream A stateless and thread-safe allocator. It's called with the size class of each small block, and it
+/// must accept the size class as the size of the block when it's deallocated.
+template<Allocator Upstream = GlobalAllocator>
+class ThreadCachingAllocator {
+	static_assert(std::is_empty_v<Upstream>, "The upstream allocator must be stateless.");
+
+public:
+	/// The smallest size class, in bytes.
+	static constexpr size_t min_cached_size = 16;
+	/// The largest size class, in bytes.
+	static constexpr size_t max_cached_size = 32_KiB;
+	/// The number of blocks moved between a thread and the depot at a time.
+	static constexpr size_t batch_size = 32;
+	/// The maximum number of batches of each size class in the depot.
+	static constexpr size_t max_depot_batches = 64;
+
+	/// @name Allocator API
+	/// @{
+
+	/// @pre
+	///   - `alignment` is a power of 2
+	static auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		BPL_DEBUG_ASSERT(is_pow2(alignment));
+		const size_t bytes = bpl::max(size, alignment);
+		if (bytes > max_cached_size) {
+			return Upstream{}.allocate(size, alignment);
+		}
+		// Blocks are aligned to their size class, so they can be reused for any alignment up to it
+		const size_t class_idx = class_index(bytes);
+		if (thread_cache_destroyed) {
+			return Upstream{}.allocate(class_size(class_idx), class_size(class_idx));
+		}
+		return thread_cache().allocate(class_idx);
+	}
+
+	/// @pre
+	///   - `block` was returned by `allocate`, with the same size
+	static void deallocate(MemoryBlock block, size_t alignment) {
+		// Like `allocate`, so that a block allocated from `Upstream` because of its alignment goes back to it
+		if (bpl::max(block.size, alignment) > max_cached_size) {
+			Upstream{}.deallocate(block, alignment);
+			return;
+		}
+		BPL_DEBUG_ASSERT(is_pow2(block.size) && block.size >= min_cached_size);
+		if (thread_cache_destroyed) {
+			Upstream{}.deallocate(block, block.size);
+			return;
+		}
+		thread_cache().deallocate(static_cast<FreeBlock*>(block.ptr), class_index(block.size));
+	}
+
+	/// @}
+
+private:
+	static constexpr size_t min_class_shift = find_last_set(min_cached_size);
+	static constexpr size_t class_count = find_last_set(max_cached_size) - min_class_shift + 1;
+
+	// A free block, in a list of free blocks
+	struct FreeBlock {
+		FreeBlock* next;
+		// The next batch in the depot, only set in the first block of a batch
+		FreeBlock* next_batch;
+	};
+
+	static_assert(sizeof(FreeBlock) <= min_cached_size);
+
+	// The batches of free blocks of a size class, shared by all threads
+	struct alignas(CACHE_LINE_SIZE) Depot {
+		std::mutex mutex;
+		FreeBlock* batches = nullptr;
+		size_t batch_count = 0;
+	};
+
+	// The free blocks of a thread
+	struct ThreadCache {
+		FreeBlock* free[class_count] = {};
+		size_t count[class_count] = {};
+
+		ThreadCache() = default;
+
+		ThreadCache(const ThreadCache&) = delete;
+		auto operator=(const ThreadCache&) -> ThreadCache& = delete;
+
+		// Moves the full batches to the depot, and gives the other blocks back to `Upstream`.
+		~ThreadCache() {
+			for (size_t class_idx = 0; class_idx < class_count; ++class_idx) {
+				for (; count[class_idx] >= batch_size; count[class_idx] -= batch_size) {
+					push_batch(class_idx, take_batch(free[class_idx]));
+				}
+				release_list(class_idx, std::exchange(free[class_idx], nullptr));
+				count[class_idx] = 0;
+			}
+			thread_cache_destroyed = true;
+		}
+
+		auto allocate(size_t class_idx) -> MemoryBlock {
+			if (free[class_idx] == nullptr) {
+				free[class_idx] = pop_batch(class_idx);
+				count[class_idx] = free[class_idx] != nullptr ? batch_size : 0;
+			}
+			if (free[class_idx] == nullptr) {
+				return Upstream{}.allocate(class_size(class_idx), class_size(class_idx));
+			}
+			count[class_idx] -= 1;
+			return { .ptr = std::exchange(free[class_idx], free[class_idx]->next), .size = class_size(class_idx) };
+		}
+
+		void deallocate(void* ptr, size_t class_idx) {
+			free[class_idx] = ::new (ptr) FreeBlock{ .next = free[class_idx], .next_batch = nullptr };
+			count[class_idx] += 1;
+			if (count[class_idx] > 2 * batch_size) {
+				push_batch(class_idx, take_tail_batch(free[class_idx], count[class_idx]));
+				count[class_idx] -= batch_size;
+			}
+		}
+	};
+
+	static inline thread_local bool thread_cache_destroyed = false;
+
+	static auto thread_cache() -> ThreadCache& {
+		thread_local ThreadCache cache;
+		return cache;
+	}
+
+	static auto depots() -> Depot (&)[class_count] {
+		static Depot depots[class_count];
+		return depots;
+	}
+
+	static constexpr auto class_size(size_t class_idx) -> size_t { return size_t{ 1 } << (class_idx + min_class_shift); }
+
+	static constexpr auto class_index(size_t size) -> size_t {
+		if (size <= min_cached_size) {
+			return 0;
+		}
+		return find_last_set(size - 1) + 1 - min_class_shift;
+	}
+
+	// Detaches the first `batch_size` blocks of `list`, which has at least `batch_size` blocks.
+	//
+	// The depot only holds full batches, so that a thread knows how many blocks it takes from it.
+	static auto take_batch(FreeBlock*& list) -> FreeBlock* {
+		FreeBlock* first = list;
+		FreeBlock* last = first;
+		for (size_t i = 1; i < batch_size; ++i) {
+			BPL_DEBUG_ASSERT(last->next != nullptr);
+			last = last->next;
+		}
+		list = std::exchange(last->next, nullptr);
+		return first;
+	}
+
+	// Detaches the last `batch_size` blocks of `list`, which has `count` blocks, more than `batch_size`.
+	//
+	// The last blocks were deallocated first, so they're the least likely to be in the cache of the thread.
+	static auto take_tail_batch(FreeBlock* list, size_t count) -> FreeBlock* {
+		BPL_DEBUG_ASSERT(count > batch_size);
+		FreeBlock* last_kept = list;
+		for (size_t i = 1; i < count - batch_size; ++i) {
+			last_kept = last_kept->next;
+		}
+		return std::exchange(last_kept->next, nullptr);
+	}
+
+	// Gives the blocks of `list` back to `Upstream`.
+	static void release_list(size_t class_idx, FreeBlock* list) {
+		const size_t size = class_size(class_idx);
+		while (list != nullptr) {
+			Upstream{}.deallocate({ .ptr = std::exchange(list, list->next), .size = size }, size);
+		}
+	}
+
+	static void push_batch(size_t class_idx, FreeBlock* batch) {
+		Depot& depot = depots()[class_idx];
+		{
+			std::lock_guard lock(depot.mutex);
+			if (depot.batch_count < max_depot_batches) {
+				batch->next_batch = std::exchange(depot.batches, batch);
+				depot.batch_count += 1;
+				return;
+			}
+		}
+		release_list(class_idx, batch);
+	}
+
+	// Returns a batch of exactly `batch_size` blocks, or `nullptr` if the depot is empty.
+	static auto pop_batch(size_t class_idx) -> FreeBlock* {
+		Depot& depot = depots()[class_idx];
+		std::lock_guard lock(depot.mutex);
+		if (depot.batches == nullptr) {
+			return nullptr;
+		}
+		depot.batch_count -= 1;
+		return std::exchange(depot.batches, depot.batches->next_batch);
+	}
+};
+
+} // namespace bpl
@@ -0,0 +1,400 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/// @file
+/// A Two-Level Segregated Fit allocator, with constant time operations.
+
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/os.hpp>
+#include <bpl/ptr.hpp>
+
+#include <new>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bpl {
+
+namespace detail {
+
+// Header before the memory of each block of a TLSF allocator.
+struct TlsfBlock {
+	// The size of the memory of the block, a multiple of `tlsf_granularity`, and the flags in the low bits
+	size_t size_and_flags;
+	// The previous block in memory, `nullptr` for the first block
+	TlsfBlock* prev_physical;
+	// The next and previous free blocks in the same list, stored in the memory of a free block
+	TlsfBlock* next_free;
+	TlsfBlock* prev_free;
+};
+
+// The alignment and the size granularity of the blocks.
+inline constexpr size_t tlsf_granularity = 16;
+// The size of the header of each block.
+inline constexpr size_t tlsf_header_size = align_forward(2 * sizeof(void*), tlsf_granularity);
+// The smallest block, which must fit the pointers of the free lists.
+inline constexpr size_t tlsf_min_block_size = 2 * sizeof(void*);
+
+} // namespace detail
+
+/// A Two-Level Segregated Fit (TLSF) allocator, whose operations take constant time in the worst case.
+///
+/// The allocator manages a region of memory reserved with `reserve_memory`. Free blocks are kept in lists indexed by
+/// two levels of size classes: the first level is the power of 2 of the size, and the second level splits it in
+/// `second_level_count` linear ranges. Two levels of bitmaps record which lists are not empty, so that finding a large
+/// enough free block takes two bit scans. Each block has a header that links it to the previous block in memory, and
+/// adjacent free blocks are merged immediately.
+class TlsfAllocator {
+public:
+	/// The number of ranges in each power of 2.
+	static constexpr uint32_t second_level_count = 16;
+
+	//////////////////////////////////////////////////
+	/// @name Special member functions
+	/// @{
+
+	TlsfAllocator() = default;
+
+	TlsfAllocator(const TlsfAllocator&) = delete;
+	auto operator=(const TlsfAllocator&) -> TlsfAllocator& = delete;
+
+	TlsfAllocator(TlsfAllocator&& other) noexcept
+		: m_region(std::exchange(other.m_region, {})),
+		  m_first_level_bitmap(std::exchange(other.m_first_level_bitmap, 0)) {
+		this->take_lists(other);
+	}
+	auto operator=(TlsfAllocator&& other) noexcept -> TlsfAllocator& {
+		if (this != &other) {
+			this->release();
+			m_region = std::exchange(other.m_region, {});
+			m_first_level_bitmap = std::exchange(other.m_first_level_bitmap, 0);
+			this->take_lists(other);
+		}
+		return *this;
+	}
+
+	~TlsfAllocator() { this->release(); }
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Constructors
+	/// @{
+
+	/// Creates an allocator that manages `capacity` bytes, including the headers of the blocks.
+	///
+	/// Aborts if memory allocation fails.
+	///
+	/// @pre
+	///   - `capacity > 0`
+	explicit TlsfAllocator(size_t capacity) {
+		BPL_ASSERT(capacity > 0);
+		m_region = reserve_memory(capacity + (2 * detail::tlsf_header_size) + detail::tlsf_min_block_size);
+		BPL_ASSERT(try_commit_memory(m_region));
+
+		// One free block followed by an empty used block, so that the last block doesn't need special cases
+		auto* block = ::new (m_region.ptr) detail::TlsfBlock{};
+		block->size_and_flags = m_region.size - (2 * detail::tlsf_header_size);
+		::new (next_physical(block)) detail::TlsfBlock{ .size_and_flags = 0, .prev_physical = block };
+		this->insert_free(block);
+	}
+
+	/// @}
+
+	//////////////////////////////////////////////////
+	/// @name Inspection
+	/// @{
+
+	/// Returns the size of the managed region, in bytes.
+	[[nodiscard]]
+	auto capacity() const -> size_t {
+		return m_region.size;
+	}
+
+	/// Returns `true` if `block` lies in the managed region.
+	[[nodiscard]]
+	auto owns(MemoryBlock block) const -> bool {
+		const auto* begin = static_cast<const std::byte*>(m_region.ptr);
+		return pointer_in_range(begin, static_cast<const std::byte*>(block.ptr), begin + m_region.size);
+	}
+
+	/// @}
+
+	/// @name Allocator API
+	/// @{
+
+	/// Allocates at least `size` bytes aligned to `alignment`, in constant time.
+	///
+	/// @returns The allocated block, or an empty block if there isn't a large enough free block.
+	[[nodiscard]]
+	auto allocate(size_t size, size_t alignment) -> MemoryBlock {
+		BPL_DEBUG_ASSERT(is_pow2(alignment));
+		if (size > m_region.size) {
+			return {};
+		}
+		size = block_size_for(size);
+		// A larger alignment needs room for a free block before the aligned one
+		const size_t padding = alignment > detail::tlsf_granularity
+			? alignment + detail::tlsf_header_size + detail::tlsf_min_block_size
+			: 0;
+		detail::TlsfBlock* block = this->find_free(size + padding);
+		if (block == nullptr) {
+			return {};
+		}
+		this->remove_free(block);
+		if (!is_aligned(memory_of(block), alignment)) {
+			block = this->split_front(block, alignment);
+		}
+		this->split(block, size);
+		block->size_and_flags &= ~free_flag;
+		return { .ptr = memory_of(block), .size = size_of(block) };
+	}
+
+	/// Deallocates `block`, merging it with the adjacent free blocks, in constant time.
+	///
+	/// @pre
+	///   - `block` was returned by this allocator.
+	void deallocate(MemoryBlock block, size_t /*alignment*/) {
+		BPL_DEBUG_ASSERT(this->owns(block));
+		detail::TlsfBlock* header = header_of(block.ptr);
+		BPL_DEBUG_ASSERT(!is_free(header));
+		header->size_and_flags |= free_flag;
+		this->insert_free(this->merge(header));
+	}
+
+	/// Grows `block` in-place by taking memory from the next block if it's free, in constant time.
+	[[nodiscard]]
+	auto try_grow(MemoryBlock block, size_t /*alignment*/, size_t additional) -> MemoryBlock {
+		BPL_DEBUG_ASSERT(this->owns(block));
+		detail::TlsfBlock* header = header_of(block.ptr);
+		if (additional > m_region.size) {
+			return {};
+		}
+		const size_t new_size = block_size_for(block.size + additional);
+		if (new_size > size_of(header)) {
+			detail::TlsfBlock* next = next_physical(header);
+			if (!is_free(next) || size_of(header) + detail::tlsf_header_size + size_of(next) < new_size) {
+				return {};
+			}
+			this->remove_free(next);
+			header->size_and_flags += detail::tlsf_header_size + size_of(next);
+			next_physical(header)->prev_physical = header;
+			this->split(header, new_size);
+		}
+		return { .ptr = block.ptr, .size = size_of(header) };
+	}
+
+	/// Shrinks `block` in-place, giving the memory after `new_size` bytes back when it fits a block, in constant time.
+	[[nodiscard]]
+	auto try_shrink(MemoryBlock block, size_t /*alignment*/, size_t new_size) -> bool {
+		BPL_DEBUG_ASSERT(this->owns(block));
+		if (new_size > block.size) {
+			return false;
+		}
+		detail::TlsfBlock* header = header_of(block.ptr);
+		detail::TlsfBlock* rest = this->split(header, block_size_for(new_size));
+		if (rest != nullptr) {
+			this->remove_free(rest);
+			this->insert_free(this->merge(rest));
+		}
+		return true;
+	}
+
+	/// @}
+
+private:
+	static constexpr size_t free_flag = 1;
+	static constexpr uint32_t second_level_log2 = find_last_set(second_level_count);
+	// Sizes below this are in the first list of the first level, split in linear ranges of `tlsf_granularity` bytes
+	static constexpr size_t small_block_size = second_level_count * detail::tlsf_granularity;
+	static constexpr uint32_t first_level_shift = find_last_set(small_block_size);
+	static constexpr uint32_t first_level_count = bits_of<size_t> - first_level_shift;
+
+	MemoryBlock m_region = {};
+	uint64_t m_first_level_bitmap = 0;
+	uint32_t m_second_level_bitmaps[first_level_count] = {};
+	detail::TlsfBlock* m_free[first_level_count][second_level_count] = {};
+
+	struct ListIndex {
+		uint32_t first;
+		uint32_t second;
+	};
+
+	static auto block_size_for(size_t size) -> size_t {
+		return align_forward(bpl::max(size, detail::tlsf_min_block_size), detail::tlsf_granularity);
+	}
+
+	static auto is_aligned(void* ptr, size_t alignment) -> bool { return ptr_to_addr(ptr) % alignment == 0; }
+
+	static auto size_of(const detail::TlsfBlock* block) -> size_t { return block->size_and_flags & ~free_flag; }
+
+	static auto is_free(const detail::TlsfBlock* block) -> bool { return (block->size_and_flags & free_flag) != 0; }
+
+	static auto memory_of(detail::TlsfBlock* block) -> void* {
+		return addr_to_ptr<void>(ptr_to_addr(block) + detail::tlsf_header_size);
+	}
+
+	static auto header_of(void* ptr) -> detail::TlsfBlock* {
+		return addr_to_ptr<detail::TlsfBlock>(ptr_to_addr(ptr) - detail::tlsf_header_size);
+	}
+
+	static auto next_physical(detail::TlsfBlock* block) -> detail::TlsfBlock* {
+		return addr_to_ptr<detail::TlsfBlock>(ptr_to_addr(memory_of(block)) + size_of(block));
+	}
+
+	// Returns the list that contains the free blocks of `size` bytes.
+	static auto list_of(size_t size) -> ListIndex {
+		if (size < small_block_size) {
+			return { .first = 0, .second = static_cast<uint32_t>(size / detail::tlsf_granularity) };
+		}
+		const uint32_t log2 = find_last_set(size);
+		return {
+			.first = log2 - first_level_shift + 1,
+			.second = static_cast<uint32_t>(size >> (log2 - second_level_log2)) ^ second_level_count,
+		};
+	}
+
+	// Returns a free block of at least `size` bytes, without removing it from its list.
+	[[nodiscard]]
+	auto find_free(size_t size) const -> detail::TlsfBlock* {
+		// Rounds up to the next list, whose blocks are all large enough
+		if (size >= small_block_size) {
+			size += (size_t{ 1 } << (find_last_set(size) - second_level_log2)) - 1;
+		}
+		ListIndex index = list_of(size);
+		if (index.first >= first_level_count) {
+			return nullptr;
+		}
+		uint32_t second_level_bitmap = m_second_level_bitmaps[index.first] & (~uint32_t{ 0 } << index.second);
+		if (second_level_bitmap == 0) {
+			if (index.first + 1 >= first_level_count) {
+				return nullptr;
+			}
+			const uint64_t first_level_bitmap = m_first_level_bitmap & (~uint64_t{ 0 } << (index.first + 1));
+			if (first_level_bitmap == 0) {
+				return nullptr;
+			}
+			index.first = find_first_set(first_level_bitmap);
+			second_level_bitmap = m_second_level_bitmaps[index.first];
+		}
+		index.second = find_first_set(second_level_bitmap);
+		return m_free[index.first][index.second];
+	}
+
+	void insert_free(detail::TlsfBlock* block) {
+		const ListIndex index = list_of(size_of(block));
+		detail::TlsfBlock*& head = m_free[index.first][index.second];
+		block->next_free = head;
+		block->prev_free = nullptr;
+		if (head != nullptr) {
+			head->prev_free = block;
+		}
+		head = block;
+		m_first_level_bitmap |= uint64_t{ 1 } << index.first;
+		m_second_level_bitmaps[index.first] |= uint32_t{ 1 } << index.second;
+	}
+
+	void remove_free(detail::TlsfBlock* block) {
+		const ListIndex index = list_of(size_of(block));
+		if (block->next_free != nullptr) {
+			block->next_free->prev_free = block->prev_free;
+		}
+		if (block->prev_free != nullptr) {
+			block->prev_free->next_free = block->next_free;
+			return;
+		}
+		m_free[index.first][index.second] = block->next_free;
+		if (block->next_free == nullptr) {
+			m_second_level_bitmaps[index.first] &= ~(uint32_t{ 1 } << index.second);
+			if (m_second_level_bitmaps[index.first] == 0) {
+				m_first_level_bitmap &= ~(uint64_t{ 1 } << index.first);
+			}
+		}
+	}
+
+	// Cuts the end of `block` after `size` bytes into a new free block, if it's large enough.
+	//
+	// @returns The new free block, or `nullptr` if the rest is too small.
+	auto split(detail::TlsfBlock* block, size_t size) -> detail::TlsfBlock* {
+		if (size_of(block) < size + detail::tlsf_header_size + detail::tlsf_min_block_size) {
+			return nullptr;
+		}
+		auto* rest = addr_to_ptr<detail::TlsfBlock>(ptr_to_addr(memory_of(block)) + size);
+		rest->size_and_flags = (size_of(block) - size - detail::tlsf_header_size) | free_flag;
+		rest->prev_physical = block;
+		next_physical(rest)->prev_physical = rest;
+		block->size_and_flags = size | (block->size_and_flags & free_flag);
+		this->insert_free(rest);
+		return rest;
+	}
+
+	// Cuts the beginning of a free block into a new free block, so that the memory of the rest is aligned.
+	//
+	// @returns The rest of the block, not in any list.
+	auto split_front(detail::TlsfBlock* block, size_t alignment) -> detail::TlsfBlock* {
+		const uintptr_t memory = align_forward(
+			ptr_to_addr(memory_of(block)) + detail::tlsf_header_size + detail::tlsf_min_block_size, alignment
+		);
+		auto* aligned = header_of(addr_to_ptr<void>(memory));
+		const size_t front_size = ptr_to_addr(aligned) - ptr_to_addr(memory_of(block));
+		aligned->size_and_flags = (size_of(block) - front_size - detail::tlsf_header_size) | free_flag;
+		aligned->prev_physical = block;
+		next_physical(aligned)->prev_physical = aligned;
+		block->size_and_flags = front_size | free_flag;
+		this->insert_free(block);
+		return aligned;
+	}
+
+	// Merges a free block with the adjacent free blocks, which are removed from their lists.
+	//
+	// @returns The merged block, not in any list.
+	auto merge(detail::TlsfBlock* block) -> detail::TlsfBlock* {
+		detail::TlsfBlock* next = next_physical(block);
+		if (is_free(next)) {
+			this->remove_free(next);
+			block->size_and_flags += detail::tlsf_header_size + size_of(next);
+			next_physical(block)->prev_physical = block;
+		}
+		detail::TlsfBlock* prev = block->prev_physical;
+		if (prev != nullptr && is_free(prev)) {
+			this->remove_free(prev);
+			prev->size_and_flags += detail::tlsf_header_size + size_of(block);
+			next_physical(prev)->prev_physical = prev;
+			block = prev;
+		}
+		return block;
+	}
+
+	void take_lists(TlsfAllocator& other) {
+		for (uint32_t first = 0; first < first_level_count; ++first) {
+			m_second_level_bitmaps[first] = std::exchange(other.m_second_level_bitmaps[first], 0);
+			for (uint32_t second = 0; second < second_level_count; ++second) {
+				m_free[first][second] = std::exchange(other.m_free[first][second], nullptr);
+			}
+		}
+	}
+
+	// Releases the region.
+	void release() {
+		if (m_region.ptr != nullptr) {
+			(void) try_decommit_memory(m_region);
+			(void) try_release_memory(m_region);
+			m_region = {};
+		}
+		m_first_level_bitmap = 0;
+		for (uint32_t first = 0; first < first_level_count; ++first) {
+			m_second_level_bitmaps[first] = 0;
+			for (uint32_t second = 0; second < second_level_count; ++second) {
+				m_free[first][second] = nullptr;
+			}
+		}
+	}
+};
+
+} // namespace bpl
@@ -29,4 +29,14 @@ concept trivially_destructible = std::is_trivially_destructible_v<T>;
 template<typename T>
 concept relocatable = std::movable<T> && std::destructible<T>;
 
+/// Specialize to `true` for types whose objects can be relocated by copying their bytes, e.g., with `memcpy`.
+///
+/// Trivially copyable types are trivially relocatable by default.
+template<typename T>
+inline constexpr bool enable_trivially_relocatable = std::is_trivially_copyable_v<T>;
+
+/// Moving an object of type `T` to a new address and destroying the original is equivalent to copying its bytes.
+template<typename T>
+concept trivially_relocatable = relocatable<T> && enable_trivially_relocatable<std::remove_cv_t<T>>;
+
 } // namespace bpl
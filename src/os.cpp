@@ -3,21 +3,208 @@
 
 #include <bpl/assert.hpp>
 #include <bpl/bit.hpp>
+#include <bpl/math.hpp>
 #include <bpl/memory.hpp>
 #include <bpl/os.hpp>
+#include <bpl/ptr.hpp>
 
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
 
 namespace bpl {
 
-auto reserve_memory(size_t size) -> MemoryBlock {
-	BPL_DEBUG_ASSERT(size > 0);
-	const size_t allocation_bytes = align_forward(size, get_page_size());
-	void* ptr = mmap(nullptr, allocation_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+namespace {
+
+// Reads the first unsigned integer that matches `format` in a line of the file at `path`.
+auto read_value(const char* path, const char* format) -> size_t {
+	std::FILE* file = std::fopen(path, "r");
+	if (file == nullptr) {
+		return 0;
+	}
+	unsigned long long value = 0;
+	char line[256];
+	while (std::fgets(line, sizeof(line), file) != nullptr) {
+		if (std::sscanf(line, format, &value) == 1) {
+			break;
+		}
+	}
+	std::fclose(file);
+	return static_cast<size_t>(value);
+}
+
+auto get_huge_page_size_impl() -> size_t {
+#if defined(__linux__)
+	// The size of the transparent huge pages, which are mapped by a single page middle directory entry
+	size_t size = read_value("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "%llu");
+	if (size == 0) {
+		// The default size of the explicit huge pages
+		size = read_value("/proc/meminfo", "Hugepagesize: %llu kB") * 1024;
+	}
+	if (size > get_page_size() && is_pow2(size)) {
+		return size;
+	}
+#endif
+	return get_page_size();
+}
+
+// Reserves `size` bytes at an address that is a multiple of `alignment`, by reserving more and releasing the pages
+// before and after the aligned block.
+auto reserve_aligned(size_t size, size_t alignment) -> MemoryBlock {
+	const size_t padding = alignment - get_page_size();
+	void* ptr = mmap(nullptr, size + padding, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 	BPL_ASSERT(ptr != MAP_FAILED);
-	return { .ptr = ptr, .size = allocation_bytes };
+	const uintptr_t begin = ptr_to_addr(ptr);
+	const uintptr_t aligned_begin = align_forward(begin, alignment);
+	if (aligned_begin > begin) {
+		BPL_ASSERT(munmap(ptr, aligned_begin - begin) == 0);
+	}
+	const uintptr_t end = begin + size + padding;
+	const uintptr_t aligned_end = aligned_begin + size;
+	if (end > aligned_end) {
+		BPL_ASSERT(munmap(addr_to_ptr<void>(aligned_end), end - aligned_end) == 0);
+	}
+	return { .ptr = addr_to_ptr<void>(aligned_begin), .size = size };
+}
+
+// Reserves enough pages of the given kind to fit `size` bytes.
+auto reserve_pages(size_t size, HugePages huge_pages) -> MemoryBlock {
+	if (huge_pages == HugePages::none) {
+		const size_t allocation_bytes = align_forward(size, get_page_size());
+		void* ptr = mmap(nullptr, allocation_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		BPL_ASSERT(ptr != MAP_FAILED);
+		return { .ptr = ptr, .size = allocation_bytes };
+	}
+	const size_t huge_page_size = get_huge_page_size();
+	const size_t allocation_bytes = align_forward(size, huge_page_size);
+#if defined(MAP_HUGETLB)
+	if (huge_pages == HugePages::hugetlb) {
+		// Fails if the pool of huge pages doesn't have enough free pages
+		void* ptr = mmap(nullptr, allocation_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (ptr != MAP_FAILED) {
+			return { .ptr = ptr, .size = allocation_bytes };
+		}
+	}
+#endif
+	MemoryBlock block = reserve_aligned(allocation_bytes, huge_page_size);
+#if defined(MADV_HUGEPAGE)
+	// Fails if transparent huge pages are disabled, and then the block is backed by regular pages
+	(void) madvise(block.ptr, block.size, MADV_HUGEPAGE);
+#endif
+	return block;
+}
+
+// The modes of `mbind`, from <numaif.h>, which is only installed with libnuma
+[[maybe_unused]] constexpr int mpol_default = 0;
+[[maybe_unused]] constexpr int mpol_preferred = 1;
+[[maybe_unused]] constexpr int mpol_bind = 2;
+[[maybe_unused]] constexpr int mpol_interleave = 3;
+
+// The maximum number of nodes in a node mask
+constexpr uint32_t max_numa_nodes = 1024;
+
+auto get_numa_node_count_impl() -> uint32_t {
+#if defined(__linux__)
+	// A list of ranges of online nodes, like "0-1" or "0,2-3"
+	std::FILE* file = std::fopen("/sys/devices/system/node/online", "r");
+	if (file == nullptr) {
+		return 1;
+	}
+	char line[256] = {};
+	const bool read = std::fgets(line, sizeof(line), file) != nullptr;
+	std::fclose(file);
+	if (!read) {
+		return 1;
+	}
+	// Node numbers can have holes, so the count is the highest node number plus one
+	uint32_t max_node = 0;
+	uint32_t node = 0;
+	for (const char* c = line; *c != '\0'; ++c) {
+		if (*c >= '0' && *c <= '9') {
+			node = (node * 10) + static_cast<uint32_t>(*c - '0');
+			max_node = bpl::max(max_node, node);
+		} else {
+			node = 0;
+		}
+	}
+	return bpl::min(max_node + 1, max_numa_nodes);
+#else
+	return 1;
+#endif
+}
+
+} // namespace
+
+auto get_huge_page_size() -> size_t {
+	static const size_t huge_page_size = get_huge_page_size_impl();
+	return huge_page_size;
+}
+
+auto get_numa_node_count() -> uint32_t {
+	static const uint32_t node_count = get_numa_node_count_impl();
+	return node_count;
+}
+
+auto get_current_numa_node() -> uint32_t {
+#if defined(__linux__) && defined(SYS_getcpu)
+	unsigned int cpu = 0;
+	unsigned int node = 0;
+	if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+		return node;
+	}
+#endif
+	return 0;
+}
+
+auto try_set_numa_policy(MemoryBlock block, NumaPolicy policy) -> bool {
+	BPL_DEBUG_ASSERT(block.size % get_page_size() == 0);
+	const uint32_t node_count = get_numa_node_count();
+	if (node_count <= 1 || policy.mode == NumaMode::none) {
+		return true;
+	}
+#if defined(__linux__) && defined(SYS_mbind)
+	if (policy.mode == NumaMode::preferred_local) {
+		policy = { .mode = NumaMode::preferred, .node = get_current_numa_node() };
+	}
+	BPL_DEBUG_ASSERT(policy.mode == NumaMode::interleave || policy.node < node_count);
+	constexpr size_t bits_per_word = sizeof(unsigned long) * 8;
+	unsigned long node_mask[max_numa_nodes / bits_per_word] = {};
+	int mode = mpol_default;
+	switch (policy.mode) {
+		case NumaMode::bind:
+		case NumaMode::preferred:
+			mode = policy.mode == NumaMode::bind ? mpol_bind : mpol_preferred;
+			node_mask[policy.node / bits_per_word] |= 1UL << (policy.node % bits_per_word);
+			break;
+		case NumaMode::interleave:
+			mode = mpol_interleave;
+			for (uint32_t node = 0; node < node_count; ++node) {
+				node_mask[node / bits_per_word] |= 1UL << (node % bits_per_word);
+			}
+			break;
+		case NumaMode::none:
+		case NumaMode::preferred_local:
+			break;
+	}
+	// The kernel reads `max_node - 1` bits of the mask
+	const unsigned long max_node = max_numa_nodes + 1;
+	return syscall(SYS_mbind, block.ptr, block.size, mode, node_mask, max_node, 0U) == 0;
+#else
+	(void) block;
+	return true;
+#endif
+}
+
+auto reserve_memory(size_t size, HugePages huge_pages, NumaPolicy numa) -> MemoryBlock {
+	BPL_DEBUG_ASSERT(size > 0);
+	MemoryBlock block = reserve_pages(size, huge_pages);
+	// Before the pages are touched, so that they are placed by the policy
+	(void) try_set_numa_policy(block, numa);
+	return block;
 }
 
 auto try_commit_memory(MemoryBlock block) -> bool {
@@ -33,6 +220,65 @@ auto try_decommit_memory(MemoryBlock block) -> bool {
 	return mprotect(block.ptr, block.size, PROT_NONE) == 0;
 }
 
+void prefault_memory(MemoryBlock block) {
+	BPL_DEBUG_ASSERT(block.size % get_page_size() == 0);
+#if defined(MADV_POPULATE_WRITE)
+	if (madvise(block.ptr, block.size, MADV_POPULATE_WRITE) == 0) {
+		return;
+	}
+#endif
+	// Before Linux 5.14, or if `MADV_POPULATE_WRITE` isn't supported by the mapping: writing the byte that was read
+	// makes the OS allocate the page without changing its content
+	auto* bytes = static_cast<volatile char*>(block.ptr);
+	for (size_t offset = 0; offset < block.size; offset += get_page_size()) {
+		bytes[offset] = bytes[offset];
+	}
+}
+
+auto try_advise_memory(MemoryBlock block, MemoryAdvice advice) -> bool {
+	BPL_DEBUG_ASSERT(block.size % get_page_size() == 0);
+	int native_advice = MADV_NORMAL;
+	switch (advice) {
+		case MemoryAdvice::sequential:
+			native_advice = MADV_SEQUENTIAL;
+			break;
+		case MemoryAdvice::random:
+			native_advice = MADV_RANDOM;
+			break;
+		case MemoryAdvice::willneed:
+			native_advice = MADV_WILLNEED;
+			break;
+		case MemoryAdvice::dontneed:
+			native_advice = MADV_DONTNEED;
+			break;
+		case MemoryAdvice::free:
+#if defined(MADV_FREE)
+			native_advice = MADV_FREE;
+#else
+			native_advice = MADV_DONTNEED;
+#endif
+			break;
+	}
+	return madvise(block.ptr, block.size, native_advice) == 0;
+}
+
+auto try_remap_memory(MemoryBlock block, size_t new_size) -> MemoryBlock {
+	BPL_DEBUG_ASSERT(block.size % get_page_size() == 0);
+	BPL_DEBUG_ASSERT(new_size > 0);
+#if defined(__linux__)
+	const size_t allocation_bytes = align_forward(new_size, get_page_size());
+	void* ptr = mremap(block.ptr, block.size, allocation_bytes, MREMAP_MAYMOVE);
+	if (ptr == MAP_FAILED) {
+		return {};
+	}
+	return { .ptr = ptr, .size = allocation_bytes };
+#else
+	(void) block;
+	(void) new_size;
+	return {};
+#endif
+}
+
 auto try_release_memory(MemoryBlock block) -> bool {
 	BPL_DEBUG_ASSERT(block.size % get_page_size() == 0);
 	return munmap(block.ptr, block.size) == 0;
@@ -0,0 +1,241 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/assert.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/literals.hpp>
+#include <bpl/math.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/os.hpp>
+#include <bpl/ptr.hpp>
+#include <bpl/slab_allocator.hpp>
+
+#include <atomic>
+#include <bit>
+#include <new>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bpl {
+
+namespace {
+
+constexpr size_t min_class_shift = std::countr_zero(SlabAllocator::min_small_size);
+constexpr size_t class_count = std::countr_zero(SlabAllocator::max_small_size) - min_class_shift + 1;
+
+// Each thread caches at most this many bytes of free blocks for each size class, and at least 2 blocks
+constexpr size_t cache_bytes = 64_KiB;
+
+constexpr auto class_size(size_t class_idx) -> size_t {
+	return size_t{ 1 } << (class_idx + min_class_shift);
+}
+
+constexpr auto class_index(size_t size) -> size_t {
+	return static_cast<size_t>(std::bit_width(bpl::max(size, SlabAllocator::min_small_size) - 1)) - min_class_shift;
+}
+
+constexpr auto max_cached(size_t class_idx) -> size_t {
+	return bpl::max(cache_bytes / class_size(class_idx), size_t{ 2 });
+}
+
+struct FreeBlock {
+	FreeBlock* next;
+};
+
+// Free blocks shared by all threads.
+//
+// Blocks are pushed with a compare-and-swap and taken all at once with an exchange, so the depot isn't subject to the
+// ABA problem.
+struct Depot {
+	alignas(CACHE_LINE_SIZE) std::atomic<FreeBlock*> head = nullptr;
+
+	// Pushes the list of blocks from `first` to `last`.
+	void push(FreeBlock* first, FreeBlock* last) {
+		FreeBlock* old_head = head.load(std::memory_order_relaxed);
+		do {
+			last->next = old_head;
+		} while (!head.compare_exchange_weak(old_head, first, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	auto take_all() -> FreeBlock* { return head.exchange(nullptr, std::memory_order_acquire); }
+};
+
+Depot depots[class_count];
+
+// The free blocks of a thread.
+struct ThreadCache {
+	FreeBlock* free[class_count] = {};
+	size_t count[class_count] = {};
+	// The part of the last slab of each size class that was never allocated
+	uintptr_t next[class_count] = {};
+	uintptr_t end[class_count] = {};
+
+	ThreadCache() = default;
+
+	ThreadCache(const ThreadCache&) = delete;
+	auto operator=(const ThreadCache&) -> ThreadCache& = delete;
+
+	// Gives all the blocks to the other threads.
+	~ThreadCache();
+
+	auto allocate(size_t class_idx) -> void*;
+
+	void deallocate(void* ptr, size_t class_idx);
+};
+
+thread_local ThreadCache thread_cache;
+// `true` after `thread_cache` is destroyed, when the thread deallocates from the destructor of another thread local
+thread_local bool thread_cache_destroyed = false;
+
+ThreadCache::~ThreadCache() {
+	for (size_t class_idx = 0; class_idx < class_count; ++class_idx) {
+		const size_t size = class_size(class_idx);
+		for (; next[class_idx] < end[class_idx]; next[class_idx] += size) {
+			this->deallocate(addr_to_ptr<void>(next[class_idx]), class_idx);
+		}
+		if (free[class_idx] != nullptr) {
+			FreeBlock* last = free[class_idx];
+			while (last->next != nullptr) {
+				last = last->next;
+			}
+			depots[class_idx].push(free[class_idx], last);
+		}
+	}
+	thread_cache_destroyed = true;
+}
+
+auto ThreadCache::allocate(size_t class_idx) -> void* {
+	if (free[class_idx] == nullptr) {
+		free[class_idx] = depots[class_idx].take_all();
+		count[class_idx] = 0;
+		for (FreeBlock* block = free[class_idx]; block != nullptr; block = block->next) {
+			count[class_idx] += 1;
+		}
+	}
+	if (free[class_idx] != nullptr) {
+		count[class_idx] -= 1;
+		return std::exchange(free[class_idx], free[class_idx]->next);
+	}
+	if (next[class_idx] == end[class_idx]) {
+		MemoryBlock slab = PagesAllocator::allocate(SlabAllocator::slab_size, get_page_size());
+		next[class_idx] = ptr_to_addr(slab.ptr);
+		end[class_idx] = next[class_idx] + slab.size;
+	}
+	return addr_to_ptr<void>(std::exchange(next[class_idx], next[class_idx] + class_size(class_idx)));
+}
+
+void ThreadCache::deallocate(void* ptr, size_t class_idx) {
+	free[class_idx] = ::new (ptr) FreeBlock{ .next = free[class_idx] };
+	count[class_idx] += 1;
+	if (count[class_idx] <= max_cached(class_idx)) {
+		return;
+	}
+	// Keeps the most recently deallocated half, which is more likely to be in the cache
+	FreeBlock* last_kept = free[class_idx];
+	for (size_t i = 1; i < count[class_idx] / 2; ++i) {
+		last_kept = last_kept->next;
+	}
+	FreeBlock* first = std::exchange(last_kept->next, nullptr);
+	FreeBlock* last = first;
+	while (last->next != nullptr) {
+		last = last->next;
+	}
+	depots[class_idx].push(first, last);
+	count[class_idx] /= 2;
+}
+
+// Allocates a block without the cache of the thread, which was already destroyed.
+auto allocate_uncached(size_t class_idx) -> void* {
+	FreeBlock* first = depots[class_idx].take_all();
+	if (first == nullptr) {
+		// Gives the rest of a new slab to the depot
+		const size_t size = class_size(class_idx);
+		MemoryBlock slab = PagesAllocator::allocate(SlabAllocator::slab_size, get_page_size());
+		for (uintptr_t addr = ptr_to_addr(slab.ptr) + size; addr < ptr_to_addr(slab.ptr) + slab.size; addr += size) {
+			auto* free_block = ::new (addr_to_ptr<void>(addr)) FreeBlock{ .next = nullptr };
+			depots[class_idx].push(free_block, free_block);
+		}
+		return slab.ptr;
+	}
+	if (first->next != nullptr) {
+		FreeBlock* last = first->next;
+		while (last->next != nullptr) {
+			last = last->next;
+		}
+		depots[class_idx].push(first->next, last);
+	}
+	return first;
+}
+
+} // namespace
+
+auto SlabAllocator::allocate(size_t size, size_t alignment) -> MemoryBlock {
+	BPL_DEBUG_ASSERT(is_pow2(alignment));
+	BPL_DEBUG_ASSERT(alignment <= get_page_size());
+	const size_t bytes = bpl::max(size, alignment);
+	if (bytes > max_small_size) {
+		return PagesAllocator::allocate(bytes, alignment);
+	}
+	// Blocks are aligned to their size, up to the page size, because the slabs are aligned to the page size
+	const size_t class_idx = class_index(bytes);
+	void* ptr = thread_cache_destroyed ? allocate_uncached(class_idx) : thread_cache.allocate(class_idx);
+	return { .ptr = ptr, .size = class_size(class_idx) };
+}
+
+void SlabAllocator::deallocate(MemoryBlock block, size_t /*alignment*/) {
+	if (block.size > max_small_size) {
+		PagesAllocator::deallocate(block, get_page_size());
+		return;
+	}
+	BPL_DEBUG_ASSERT(is_pow2(block.size) && block.size >= min_small_size);
+	const size_t class_idx = class_index(block.size);
+	if (thread_cache_destroyed) {
+		auto* free_block = ::new (block.ptr) FreeBlock{ .next = nullptr };
+		depots[class_idx].push(free_block, free_block);
+		return;
+	}
+	thread_cache.deallocate(block.ptr, class_idx);
+}
+
+auto SlabAllocator::allocate_batch(size_t size, size_t alignment, size_t count, MemoryBlock* blocks) -> bool {
+	BPL_DEBUG_ASSERT(is_pow2(alignment));
+	BPL_DEBUG_ASSERT(alignment <= get_page_size());
+	const size_t bytes = bpl::max(size, alignment);
+	if (bytes > max_small_size || thread_cache_destroyed) {
+		for (size_t i = 0; i < count; ++i) {
+			blocks[i] = SlabAllocator::allocate(size, alignment);
+		}
+		return true;
+	}
+	const size_t class_idx = class_index(bytes);
+	const size_t block_size = class_size(class_idx);
+	ThreadCache& cache = thread_cache;
+	for (size_t i = 0; i < count; ++i) {
+		blocks[i] = { .ptr = cache.allocate(class_idx), .size = block_size };
+	}
+	return true;
+}
+
+void SlabAllocator::deallocate_batch(const MemoryBlock* blocks, size_t count, size_t alignment) {
+	if (count == 0) {
+		return;
+	}
+	if (blocks[0].size > max_small_size || thread_cache_destroyed) {
+		for (size_t i = 0; i < count; ++i) {
+			SlabAllocator::deallocate(blocks[i], alignment);
+		}
+		return;
+	}
+	// The blocks of a batch have the same size
+	const size_t class_idx = class_index(blocks[0].size);
+	ThreadCache& cache = thread_cache;
+	for (size_t i = count; i > 0; --i) {
+		BPL_DEBUG_ASSERT(blocks[i - 1].size == blocks[0].size);
+		cache.deallocate(blocks[i - 1].ptr, class_idx);
+	}
+}
+
+} // namespace bpl
@@ -2,3 +2,199 @@
 // SPDX-License-Identifier: MIT
 
 #include <bpl/allocator.hpp>
+#include <bpl/array.hpp>
+#include <bpl/bit.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/os.hpp>
+#include <bpl/ptr.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <initializer_list>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST(PagesAllocator, reallocate) {
+	static_assert(bpl::ReallocatableAllocator<bpl::PagesAllocator>);
+
+	const size_t page_size = bpl::get_page_size();
+	bpl::MemoryBlock block = bpl::PagesAllocator::allocate(page_size, alignof(uint64_t));
+	auto* data = static_cast<uint64_t*>(block.ptr);
+	for (size_t i = 0; i < page_size / sizeof(uint64_t); ++i) {
+		data[i] = i;
+	}
+
+	bpl::MemoryBlock new_block = bpl::PagesAllocator::reallocate(block, alignof(uint64_t), 64 * page_size);
+#if defined(__linux__)
+	ASSERT_NE(new_block.ptr, nullptr);
+	EXPECT_EQ(new_block.size, 64 * page_size);
+	data = static_cast<uint64_t*>(new_block.ptr);
+	for (size_t i = 0; i < page_size / sizeof(uint64_t); ++i) {
+		ASSERT_EQ(data[i], i);
+	}
+	data[(64 * page_size / sizeof(uint64_t)) - 1] = 42;
+	bpl::PagesAllocator::deallocate(new_block, alignof(uint64_t));
+#else
+	EXPECT_EQ(new_block, bpl::MemoryBlock{});
+	bpl::PagesAllocator::deallocate(block, alignof(uint64_t));
+#endif
+}
+
+TEST(PagesAllocator, arrayGrowth) {
+	bpl::Array<uint64_t, bpl::PagesAllocator> array;
+	for (uint64_t i = 0; i < 100'000; ++i) {
+		array.append(i);
+	}
+	for (uint64_t i = 0; i < 100'000; ++i) {
+		ASSERT_EQ(array[i], i);
+	}
+}
+
+TEST(AllocatorRef, concepts) {
+	EXPECT_TRUE(bpl::Allocator<bpl::AllocatorRef<bpl::GlobalAllocator>>);
+	EXPECT_FALSE(bpl::GrowableAllocator<bpl::AllocatorRef<bpl::GlobalAllocator>>);
+	EXPECT_TRUE(bpl::ReallocatableAllocator<bpl::AllocatorRef<bpl::PagesAllocator>>);
+}
+
+TEST(AllocatorRef, forward) {
+	bpl::GlobalAllocator global;
+	bpl::AllocatorRef ref(global);
+	EXPECT_EQ(&ref.get(), &global);
+	EXPECT_EQ(ref, bpl::AllocatorRef(global));
+
+	bpl::MemoryBlock block = ref.allocate(16u, 8u);
+	EXPECT_NE(block.ptr, nullptr);
+	ref.deallocate(block, 8u);
+}
+
+TEST(BatchAllocator, fallback) {
+	EXPECT_FALSE(bpl::BatchAllocator<bpl::GlobalAllocator>);
+
+	bpl::GlobalAllocator global;
+	bpl::MemoryBlock blocks[4];
+	ASSERT_TRUE(bpl::allocate_batch(global, 24u, 8u, 4u, blocks));
+	for (bpl::MemoryBlock block : blocks) {
+		EXPECT_NE(block.ptr, nullptr);
+		EXPECT_EQ(block.size, 24u);
+	}
+	bpl::deallocate_batch(global, blocks, 4u, 8u);
+}
+
+namespace {
+
+// Returns the number of pages of `block` that are backed by physical memory.
+auto resident_pages(bpl::MemoryBlock block) -> size_t {
+	const size_t page_count = block.size / bpl::get_page_size();
+	bpl::Array<unsigned char> residency(page_count, 0);
+	EXPECT_EQ(mincore(block.ptr, block.size, residency.data()), 0);
+	return static_cast<size_t>(std::count_if(residency.begin(), residency.end(), [](unsigned char r) {
+		return (r & 1) != 0;
+	}));
+}
+
+} // namespace
+
+TEST(PrefaultMemory, populatesPages) {
+	const size_t page_size = bpl::get_page_size();
+	bpl::MemoryBlock block = bpl::reserve_memory(8 * page_size);
+	ASSERT_TRUE(bpl::try_commit_memory(block));
+	static_cast<char*>(block.ptr)[page_size] = 42;
+	EXPECT_LT(resident_pages(block), 8u);
+
+	bpl::prefault_memory(block);
+	EXPECT_EQ(resident_pages(block), 8u);
+	EXPECT_EQ(static_cast<char*>(block.ptr)[page_size], 42);
+	EXPECT_TRUE(bpl::try_release_memory(block));
+}
+
+TEST(AdviseMemory, advice) {
+	const size_t page_size = bpl::get_page_size();
+	bpl::MemoryBlock block = bpl::reserve_memory(4 * page_size);
+	ASSERT_TRUE(bpl::try_commit_memory(block));
+	for (bpl::MemoryAdvice advice : {
+			 bpl::MemoryAdvice::sequential,
+			 bpl::MemoryAdvice::random,
+			 bpl::MemoryAdvice::willneed,
+			 bpl::MemoryAdvice::free,
+		 }) {
+		EXPECT_TRUE(bpl::try_advise_memory(block, advice));
+	}
+
+	static_cast<char*>(block.ptr)[0] = 42;
+	EXPECT_TRUE(bpl::try_advise_memory(block, bpl::MemoryAdvice::dontneed));
+	EXPECT_EQ(static_cast<char*>(block.ptr)[0], 0);
+	EXPECT_TRUE(bpl::try_release_memory(block));
+}
+
+TEST(PagesAllocator, prefault) {
+	using Allocator = bpl::BasicPagesAllocator<bpl::HugePages::none, true>;
+	bpl::MemoryBlock block = Allocator::allocate(4 * bpl::get_page_size(), 8u);
+	EXPECT_EQ(resident_pages(block), 4u);
+	block = Allocator::reallocate(block, 8u, 8 * bpl::get_page_size());
+	ASSERT_NE(block.ptr, nullptr);
+	EXPECT_EQ(resident_pages(block), 8u);
+	Allocator::deallocate(block, 8u);
+}
+
+TEST(HugePages, hugePageSize) {
+	const size_t huge_page_size = bpl::get_huge_page_size();
+	EXPECT_GE(huge_page_size, bpl::get_page_size());
+	EXPECT_TRUE(bpl::is_pow2(huge_page_size));
+}
+
+TEST(HugePages, reserve) {
+	const size_t huge_page_size = bpl::get_huge_page_size();
+	for (bpl::HugePages huge_pages : { bpl::HugePages::transparent, bpl::HugePages::hugetlb }) {
+		bpl::MemoryBlock block = bpl::reserve_memory(huge_page_size + 1, huge_pages);
+		EXPECT_EQ(bpl::ptr_to_addr(block.ptr) % huge_page_size, 0u);
+		EXPECT_EQ(block.size, 2 * huge_page_size);
+		ASSERT_TRUE(bpl::try_commit_memory(block));
+		static_cast<char*>(block.ptr)[block.size - 1] = 42;
+		EXPECT_TRUE(bpl::try_release_memory(block));
+	}
+}
+
+TEST(HugePagesAllocator, arrayGrowth) {
+	bpl::Array<int, bpl::HugePagesAllocator> array;
+	for (int i = 0; i < 1'000'000; ++i) {
+		array.append(i);
+	}
+	EXPECT_EQ(array[999'999], 999'999);
+}
+
+TEST(Numa, nodes) {
+	const uint32_t node_count = bpl::get_numa_node_count();
+	EXPECT_GE(node_count, 1u);
+	EXPECT_LT(bpl::get_current_numa_node(), node_count);
+}
+
+TEST(Numa, policies) {
+	const size_t page_size = bpl::get_page_size();
+	const uint32_t node = bpl::get_current_numa_node();
+	for (bpl::NumaPolicy policy : {
+			 bpl::NumaPolicy{ .mode = bpl::NumaMode::bind, .node = node },
+			 bpl::NumaPolicy{ .mode = bpl::NumaMode::interleave },
+			 bpl::NumaPolicy{ .mode = bpl::NumaMode::preferred, .node = node },
+			 bpl::NumaPolicy{ .mode = bpl::NumaMode::preferred_local },
+		 }) {
+		bpl::MemoryBlock block = bpl::reserve_memory(4 * page_size);
+		EXPECT_TRUE(bpl::try_set_numa_policy(block, policy));
+		ASSERT_TRUE(bpl::try_commit_memory(block));
+		static_cast<char*>(block.ptr)[block.size - 1] = 42;
+		EXPECT_TRUE(bpl::try_release_memory(block));
+	}
+}
+
+TEST(Numa, pagesAllocator) {
+	constexpr bpl::NumaPolicy interleave = { .mode = bpl::NumaMode::interleave };
+	using Allocator = bpl::BasicPagesAllocator<bpl::HugePages::none, false, interleave>;
+	bpl::Array<int, Allocator> array;
+	for (int i = 0; i < 100'000; ++i) {
+		array.append(i);
+	}
+	EXPECT_EQ(array[99'999], 99'999);
+}
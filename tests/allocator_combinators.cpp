@@ -0,0 +1,171 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/allocator_combinators.hpp>
+#include <bpl/arena.hpp>
+#include <bpl/array.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/pool_allocator.hpp>
+#include <bpl/ptr.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST(Segregator, concepts) {
+	using Segregated = bpl::Segregator<64, bpl::PoolAllocator<64>, bpl::GlobalAllocator>;
+	EXPECT_TRUE(bpl::Allocator<Segregated>);
+	EXPECT_FALSE(bpl::GrowableAllocator<Segregated>);
+
+	using Resizable = bpl::Segregator<64, bpl::Arena, bpl::Arena>;
+	EXPECT_TRUE(bpl::ResizableAllocator<Resizable>);
+}
+
+TEST(Segregator, allocate) {
+	bpl::Segregator<64, bpl::Arena, bpl::Arena> allocator(bpl::Arena(4096u), bpl::Arena(4096u));
+	bpl::MemoryBlock small = allocator.allocate(64u, 8u);
+	bpl::MemoryBlock large = allocator.allocate(65u, 8u);
+	EXPECT_TRUE(allocator.small().owns(small));
+	EXPECT_TRUE(allocator.large().owns(large));
+
+	// The small block can't grow past the threshold
+	EXPECT_EQ(allocator.try_grow(small, 8u, 8u), bpl::MemoryBlock{});
+	EXPECT_NE(allocator.try_grow(large, 8u, 8u).ptr, nullptr);
+	// The large block can't shrink below the threshold
+	EXPECT_FALSE(allocator.try_shrink(large, 8u, 64u));
+
+	allocator.deallocate(small, 8u);
+	allocator.deallocate(large, 8u);
+	EXPECT_TRUE(allocator.small().empty());
+}
+
+namespace {
+
+// An arena that rounds the size of each block up to 16 bytes.
+struct RoundingArena {
+	bpl::Arena arena{ 4096u };
+
+	auto allocate(size_t size, size_t alignment) -> bpl::MemoryBlock {
+		return arena.allocate(bpl::align_forward(size, size_t{ 16 }), alignment);
+	}
+
+	void deallocate(bpl::MemoryBlock block, size_t alignment) { arena.deallocate(block, alignment); }
+
+	auto owns(bpl::MemoryBlock block) const -> bool { return arena.owns(block); }
+};
+
+} // namespace
+
+TEST(Segregator, roundedSmallBlock) {
+	// The small allocator owns its blocks, so a block rounded up past the threshold still goes back to it
+	bpl::Segregator<100, RoundingArena, bpl::GlobalAllocator> owning;
+	bpl::MemoryBlock block1 = owning.allocate(100u, 8u);
+	EXPECT_EQ(block1.size, 112u);
+	EXPECT_TRUE(owning.small().owns(block1));
+	owning.deallocate(block1, 8u);
+	EXPECT_TRUE(owning.small().arena.empty());
+
+	// The pool returns blocks of 64 bytes, which would be deallocated by the large allocator, so it isn't used
+	bpl::Segregator<32, bpl::PoolAllocator<64>, bpl::GlobalAllocator> non_owning;
+	bpl::MemoryBlock block2 = non_owning.allocate(16u, 8u);
+	ASSERT_NE(block2.ptr, nullptr);
+	EXPECT_GT(block2.size, 32u);
+	non_owning.deallocate(block2, 8u);
+}
+
+TEST(FallbackAllocator, allocate) {
+	EXPECT_TRUE(bpl::OwningAllocator<bpl::Arena>);
+	EXPECT_TRUE((bpl::ResizableAllocator<bpl::FallbackAllocator<bpl::Arena, bpl::Arena>>));
+
+	bpl::FallbackAllocator<bpl::Arena, bpl::GlobalAllocator> allocator(bpl::Arena(4096u), bpl::GlobalAllocator{});
+	const size_t capacity = allocator.primary().capacity();
+	bpl::MemoryBlock block1 = allocator.allocate(capacity, 8u);
+	EXPECT_TRUE(allocator.primary().owns(block1));
+	bpl::MemoryBlock block2 = allocator.allocate(64u, 8u);
+	ASSERT_NE(block2.ptr, nullptr);
+	EXPECT_FALSE(allocator.primary().owns(block2));
+
+	allocator.deallocate(block2, 8u);
+	allocator.deallocate(block1, 8u);
+	EXPECT_TRUE(allocator.primary().empty());
+}
+
+namespace {
+
+struct Header {
+	uint32_t magic = 0xdeadbeef;
+};
+
+struct Guard {
+	uint64_t canary = 0x0123456789abcdef;
+};
+
+} // namespace
+
+TEST(AffixAllocator, allocate) {
+	using Affixed = bpl::AffixAllocator<bpl::GlobalAllocator, Header, Guard>;
+	Affixed allocator;
+	bpl::MemoryBlock block = allocator.allocate(20u, 16u);
+	ASSERT_NE(block.ptr, nullptr);
+	EXPECT_GE(block.size, 20u);
+	EXPECT_EQ(bpl::ptr_to_addr(block.ptr) % 16u, 0u);
+	EXPECT_EQ(Affixed::prefix(block).magic, 0xdeadbeef);
+	EXPECT_EQ(Affixed::suffix(block).canary, 0x0123456789abcdefu);
+	allocator.deallocate(block, 16u);
+}
+
+TEST(AffixAllocator, resize) {
+	using Affixed = bpl::AffixAllocator<bpl::Arena, Header, Guard>;
+	EXPECT_TRUE(bpl::ResizableAllocator<Affixed>);
+	EXPECT_FALSE((bpl::GrowableAllocator<bpl::AffixAllocator<bpl::GlobalAllocator, void, Guard>>));
+
+	Affixed allocator(bpl::Arena(4096u));
+	bpl::MemoryBlock block = allocator.allocate(16u, 8u);
+	Affixed::suffix(block).canary = 42u;
+
+	bpl::MemoryBlock grown = allocator.try_grow(block, 8u, 32u);
+	ASSERT_EQ(grown.ptr, block.ptr);
+	EXPECT_EQ(grown.size, 48u);
+	EXPECT_EQ(Affixed::suffix(grown).canary, 42u);
+	EXPECT_EQ(Affixed::prefix(grown).magic, 0xdeadbeef);
+
+	EXPECT_FALSE(allocator.try_shrink(grown, 8u, 12u));
+	ASSERT_TRUE(allocator.try_shrink(grown, 8u, 8u));
+	bpl::MemoryBlock shrunk = { .ptr = grown.ptr, .size = 8u };
+	EXPECT_EQ(Affixed::suffix(shrunk).canary, 42u);
+
+	allocator.deallocate(shrunk, 8u);
+	EXPECT_TRUE(allocator.allocator().empty());
+}
+
+TEST(StatsAllocator, stats) {
+	bpl::StatsAllocator<bpl::Arena> allocator(bpl::Arena(4096u));
+	EXPECT_TRUE(bpl::ResizableAllocator<bpl::StatsAllocator<bpl::Arena>>);
+
+	bpl::MemoryBlock block1 = allocator.allocate(16u, 8u);
+	bpl::MemoryBlock block2 = allocator.allocate(32u, 8u);
+	block2 = allocator.try_grow(block2, 8u, 16u);
+	allocator.deallocate(block2, 8u);
+	allocator.deallocate(block1, 8u);
+
+	const bpl::AllocatorStats& stats = allocator.stats();
+	EXPECT_EQ(stats.allocations, 2u);
+	EXPECT_EQ(stats.deallocations, 2u);
+	EXPECT_EQ(stats.resizes, 1u);
+	EXPECT_EQ(stats.bytes, 0u);
+	EXPECT_EQ(stats.peak_bytes, 64u);
+	EXPECT_EQ(stats.total_bytes, 64u);
+}
+
+TEST(StatsAllocator, array) {
+	bpl::Array<int, bpl::StatsAllocator<bpl::GlobalAllocator>> array;
+	array.append(1);
+	array.append(2);
+	array.append(3);
+	const bpl::AllocatorStats& stats = array.allocator().stats();
+	EXPECT_GT(stats.allocations, 1u);
+	EXPECT_EQ(stats.deallocations, stats.allocations - 1u);
+	EXPECT_EQ(stats.bytes, array.capacity() * sizeof(int));
+}
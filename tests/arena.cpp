@@ -3,14 +3,20 @@
 
 #include <bpl/allocator.hpp>
 #include <bpl/arena.hpp>
+#include <bpl/array.hpp>
 #include <bpl/memory.hpp>
+#include <bpl/os.hpp>
 #include <bpl/utility.hpp>
 
 #include <gtest/gtest.h>
 
+#include <sys/mman.h>
+
 #include <algorithm>
 #include <array>
+#include <iterator>
 #include <span>
+#include <utility>
 
 #include <cstddef>
 #include <cstdint>
@@ -20,6 +26,7 @@ TEST(Arena, allocatorConcepts) {
 	EXPECT_TRUE(bpl::GrowableAllocator<bpl::Arena>);
 	EXPECT_TRUE(bpl::ShrinkableAllocator<bpl::Arena>);
 	EXPECT_TRUE(bpl::ResizableAllocator<bpl::Arena>);
+	EXPECT_TRUE(bpl::BatchAllocator<bpl::Arena>);
 }
 
 TEST(Arena, constructWithCapacity) {
@@ -74,3 +81,264 @@ TEST(Arena, clear) {
 	arena.clear();
 	EXPECT_TRUE(arena.empty());
 }
+
+TEST(Arena, tryGrow) {
+	constexpr size_t alignment = 4u;
+
+	bpl::Arena arena(64u);
+	bpl::MemoryBlock block1 = arena.push(16u, alignment);
+	bpl::MemoryBlock grown = arena.try_grow(block1, alignment, 16u);
+	EXPECT_EQ(grown.ptr, block1.ptr);
+	EXPECT_EQ(grown.size, 32u);
+
+	bpl::MemoryBlock block2 = arena.push(16u, alignment);
+	EXPECT_EQ(arena.try_grow(grown, alignment, 16u), bpl::MemoryBlock{});
+	EXPECT_EQ(arena.try_grow(block2, alignment, arena.capacity()), bpl::MemoryBlock{});
+}
+
+TEST(Arena, tryShrink) {
+	constexpr size_t alignment = 4u;
+
+	bpl::Arena arena(64u);
+	bpl::MemoryBlock block = arena.push(32u, alignment);
+	EXPECT_TRUE(arena.try_shrink(block, alignment, 16u));
+	EXPECT_EQ(arena.size(), 16u);
+}
+
+TEST(Arena, chained) {
+	constexpr size_t alignment = 8u;
+
+	bpl::Arena arena({ .capacity = 4096u, .chained = true });
+	EXPECT_TRUE(arena.chained());
+	const size_t first_capacity = arena.capacity();
+
+	bpl::MemoryBlock first = arena.push(first_capacity, alignment);
+	ASSERT_NE(first.ptr, nullptr);
+	bpl::MemoryBlock second = arena.push(64u, alignment);
+	ASSERT_NE(second.ptr, nullptr);
+	EXPECT_GT(arena.capacity(), first_capacity);
+	EXPECT_EQ(arena.size(), first_capacity + 64u);
+
+	// Larger than twice the previous region
+	bpl::MemoryBlock third = arena.push(64u * first_capacity, alignment);
+	ASSERT_NE(third.ptr, nullptr);
+	static_cast<char*>(third.ptr)[third.size - 1] = 42;
+	const size_t capacity = arena.capacity();
+
+	arena.clear();
+	EXPECT_TRUE(arena.empty());
+	EXPECT_EQ(arena.push(first_capacity, alignment), first);
+
+	// The regions are reused after clearing the arena
+	EXPECT_EQ(arena.push(64u, alignment), second);
+	EXPECT_EQ(arena.push(64u * first_capacity, alignment).ptr, third.ptr);
+	EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(Arena, chainedTryGrow) {
+	constexpr size_t alignment = 8u;
+
+	bpl::Arena arena({ .capacity = 4096u, .chained = true });
+	bpl::MemoryBlock block = arena.push(64u, alignment);
+	EXPECT_EQ(arena.try_grow(block, alignment, arena.capacity()), bpl::MemoryBlock{});
+	EXPECT_EQ(arena.size(), 64u);
+}
+
+TEST(Arena, move) {
+	bpl::Arena arena({ .capacity = 4096u, .chained = true });
+	bpl::MemoryBlock block = arena.push(64u, 8u);
+	bpl::Arena other(64u);
+	other = std::move(arena);
+	EXPECT_TRUE(other.chained());
+	EXPECT_EQ(other.size(), 64u);
+	EXPECT_TRUE(other.pop(block, 8u));
+}
+
+TEST(Arena, lazyCommit) {
+	const size_t page_size = bpl::get_page_size();
+
+	bpl::Arena arena({ .capacity = 1024u * page_size, .commit_step = page_size });
+	EXPECT_EQ(arena.committed(), 0u);
+
+	bpl::MemoryBlock block1 = arena.push(16u, 8u);
+	ASSERT_NE(block1.ptr, nullptr);
+	EXPECT_EQ(arena.committed(), page_size);
+
+	bpl::MemoryBlock block2 = arena.push(2u * page_size, 8u);
+	ASSERT_NE(block2.ptr, nullptr);
+	static_cast<char*>(block2.ptr)[block2.size - 1] = 42;
+	EXPECT_EQ(arena.committed(), 3u * page_size);
+
+	// The allocated memory is never decommitted
+	arena.decommit_above(0u);
+	EXPECT_EQ(arena.committed(), 3u * page_size);
+
+	arena.clear();
+	arena.decommit_above(page_size);
+	EXPECT_EQ(arena.committed(), page_size);
+	EXPECT_EQ(arena.push(16u, 8u), block1);
+	EXPECT_NE(arena.push(2u * page_size, 8u).ptr, nullptr);
+	EXPECT_EQ(arena.committed(), 3u * page_size);
+}
+
+TEST(Arena, highWater) {
+	const size_t page_size = bpl::get_page_size();
+
+	bpl::Arena arena({ .capacity = 16u * page_size, .chained = true, .high_water = page_size });
+	EXPECT_EQ(arena.committed(), arena.capacity() + bpl::detail::arena_region_header_size);
+
+	EXPECT_NE(arena.push(arena.capacity(), 8u).ptr, nullptr);
+	EXPECT_NE(arena.push(page_size, 8u).ptr, nullptr);
+	arena.clear();
+	// Only the header and the first `high_water` bytes of the first region, and the header of the second region, stay
+	// committed
+	EXPECT_EQ(arena.committed(), 3u * page_size);
+
+	// The pages are committed again when they're reused
+	bpl::MemoryBlock block = arena.push(arena.capacity(), 8u);
+	ASSERT_NE(block.ptr, nullptr);
+	static_cast<char*>(block.ptr)[block.size - 1] = 42;
+}
+
+TEST(Arena, prefault) {
+	const size_t page_size = bpl::get_page_size();
+	bpl::Arena arena(bpl::ArenaOptions{ .capacity = 16 * page_size, .commit_step = 4 * page_size, .prefault = true });
+	void* begin = arena.push(page_size, page_size).ptr;
+	ASSERT_NE(begin, nullptr);
+	const auto resident_pages = [&] {
+		unsigned char residency[16];
+		EXPECT_EQ(mincore(begin, 16 * page_size, residency), 0);
+		return std::count_if(std::begin(residency), std::end(residency), [](unsigned char r) { return (r & 1) != 0; });
+	};
+	EXPECT_EQ(resident_pages(), 4);
+	(void) arena.push(4 * page_size, 1u);
+	EXPECT_EQ(resident_pages(), 8);
+}
+
+TEST(Arena, numa) {
+	bpl::Arena arena(bpl::ArenaOptions{
+		.capacity = 64u,
+		.chained = true,
+		.numa = { .mode = bpl::NumaMode::preferred_local },
+	});
+	EXPECT_NE(arena.push(32u, 8u).ptr, nullptr);
+	EXPECT_NE(arena.push(1024u, 8u).ptr, nullptr);
+}
+
+TEST(Arena, rewind) {
+	constexpr size_t alignment = 8u;
+
+	bpl::Arena arena(4096u);
+	bpl::MemoryBlock block1 = arena.push(16u, alignment);
+	const bpl::ArenaMark mark = arena.mark();
+	bpl::MemoryBlock block2 = arena.push(32u, alignment);
+	(void) arena.push(64u, alignment);
+	arena.rewind(mark);
+	EXPECT_EQ(arena.size(), 16u);
+	EXPECT_EQ(arena.push(32u, alignment), block2);
+	EXPECT_NE(block1, block2);
+}
+
+TEST(Arena, chainedRewind) {
+	constexpr size_t alignment = 8u;
+
+	bpl::Arena arena({ .capacity = 4096u, .chained = true });
+	bpl::MemoryBlock first = arena.push(64u, alignment);
+	const bpl::ArenaMark mark = arena.mark();
+	(void) arena.push(arena.capacity(), alignment);
+	bpl::MemoryBlock block = arena.push(64u, alignment);
+	arena.rewind(mark);
+	EXPECT_EQ(arena.size(), 64u);
+	// The arena is back in the first region, right after the first block
+	EXPECT_EQ(arena.push(64u, alignment).ptr, static_cast<char*>(first.ptr) + first.size);
+	EXPECT_NE(block.ptr, nullptr);
+}
+
+TEST(Arena, scratchScope) {
+	bpl::Arena arena(4096u);
+	(void) arena.push(16u, 8u);
+	{
+		bpl::ScratchScope scope(arena);
+		(void) scope.arena().push(64u, 8u);
+		EXPECT_EQ(arena.size(), 80u);
+	}
+	EXPECT_EQ(arena.size(), 16u);
+}
+
+TEST(Arena, scratchArena) {
+	bpl::ScratchScope scratch1 = bpl::get_scratch_arena();
+	const size_t size = scratch1.arena().size();
+	{
+		bpl::ScratchScope scratch2 = bpl::get_scratch_arena(&scratch1.arena());
+		EXPECT_NE(&scratch1.arena(), &scratch2.arena());
+		EXPECT_NE(scratch2.arena().push(1024u, 8u).ptr, nullptr);
+
+		bpl::ScratchScope scratch3 = bpl::get_scratch_arena(&scratch2.arena());
+		EXPECT_EQ(&scratch1.arena(), &scratch3.arena());
+		EXPECT_NE(scratch3.arena().push(1024u, 8u).ptr, nullptr);
+	}
+	EXPECT_EQ(scratch1.arena().size(), size);
+}
+
+TEST(Arena, arenaRef) {
+	EXPECT_TRUE(bpl::Allocator<bpl::ArenaRef>);
+	EXPECT_TRUE(bpl::GrowableAllocator<bpl::ArenaRef>);
+	EXPECT_TRUE(bpl::ShrinkableAllocator<bpl::ArenaRef>);
+
+	bpl::Arena arena(4096u);
+	{
+		bpl::Array<int, bpl::ArenaRef> array1(bpl::ArenaRef{ arena });
+		bpl::Array<int, bpl::ArenaRef> array2(bpl::ArenaRef{ arena });
+		array1.append(1);
+		array2.append(2);
+		array1.append(3);
+		EXPECT_EQ(array1[1], 3);
+		EXPECT_EQ(array2[0], 2);
+		EXPECT_GE(arena.size(), 3u * sizeof(int));
+	}
+	arena.clear();
+	EXPECT_TRUE(arena.empty());
+}
+
+namespace {
+
+auto make_array(bpl::Arena& arena) -> bpl::Array<int, bpl::ArenaRef> {
+	bpl::Array<int, bpl::ArenaRef> array(bpl::ArenaRef{ arena });
+	array.append(1);
+	array.append(2);
+	return array;
+}
+
+} // namespace
+
+TEST(Arena, moveArenaRefArray) {
+	bpl::Arena arena(4096u);
+	bpl::Array<int, bpl::ArenaRef> array1 = make_array(arena);
+	EXPECT_EQ(array1.allocator(), bpl::ArenaRef{ arena });
+
+	bpl::Array<int, bpl::ArenaRef> array2(std::move(array1));
+	EXPECT_EQ(array2.size(), 2u);
+	EXPECT_EQ(array2[1], 2);
+	EXPECT_EQ(array2.allocator(), bpl::ArenaRef{ arena });
+
+	bpl::Array<int, bpl::ArenaRef> array3 = make_array(arena);
+	array3 = std::move(array2);
+	EXPECT_EQ(array3.size(), 2u);
+	array3.append(3);
+	EXPECT_EQ(array3[2], 3);
+}
+
+TEST(Arena, batch) {
+	bpl::Arena arena(1024u);
+	bpl::MemoryBlock blocks[8];
+	ASSERT_TRUE(arena.allocate_batch(12u, 8u, 8u, blocks));
+	for (size_t i = 0; i < 8u; ++i) {
+		EXPECT_EQ(blocks[i].ptr, static_cast<char*>(blocks[0].ptr) + (i * 16u));
+		EXPECT_EQ(blocks[i].size, 16u);
+	}
+	EXPECT_EQ(arena.size(), 128u);
+	EXPECT_FALSE(arena.allocate_batch(16u, 8u, arena.capacity(), blocks));
+
+	arena.deallocate_batch(blocks, 8u, 8u);
+	EXPECT_TRUE(arena.empty());
+}
@@ -1,7 +1,11 @@
 // Copyright © 2025 Luca Valsassina
 // SPDX-License-Identifier: MIT
 
+#include <bpl/arena.hpp>
 #include <bpl/array.hpp>
+#include <bpl/growth.hpp>
+#include <bpl/os.hpp>
+#include <bpl/span.hpp>
 #include <bpl/tags.hpp>
 
 #include <gtest/gtest.h>
@@ -15,6 +19,7 @@
 #include <vector>
 
 #include <cstddef>
+#include <cstdint>
 
 TEST(Array, constructDefault) {
 	bpl::Array<int> array;
@@ -232,14 +237,179 @@ TEST(Array, appendContiguousRange) {
 	}
 }
 
-// TEST(Array, insert) {
-// }
+TEST(Array, insert) {
+	bpl::Array<int> array;
+	array.append(1);
+	array.append(3);
+	array.insert(1, 2);
+	array.insert(0, 0);
+	array.insert(array.size(), 4);
+	EXPECT_TRUE(std::ranges::equal(array, std::array{ 0, 1, 2, 3, 4 }));
+}
 
-// TEST(Array, insertRange) {
-// }
+TEST(Array, insertRange) {
+	std::array data = { 1, 2, 3 };
+	bpl::Array<int> array(2, 0);
+	array.insert_range(1, data);
+	EXPECT_TRUE(std::ranges::equal(array, std::array{ 0, 1, 2, 3, 0 }));
+}
 
 // TEST(Array, pop) {
 // }
 
-// TEST(Array, remove) {
-// }
+TEST(Array, remove) {
+	std::array data = { 0, 1, 2, 3, 4, 5 };
+	bpl::Array<int> array(bpl::from_range, data);
+	EXPECT_EQ(array.remove(1), 1);
+	EXPECT_TRUE(std::ranges::equal(array, std::array{ 0, 2, 3, 4, 5 }));
+	array.remove(1, 3);
+	EXPECT_TRUE(std::ranges::equal(array, std::array{ 0, 4, 5 }));
+}
+
+namespace {
+
+// Owns a heap allocation, so it's not trivially copyable, but it can be relocated with `memcpy`.
+struct Boxed {
+	std::unique_ptr<int> value;
+
+	explicit Boxed(int x) : value(std::make_unique<int>(x)) {}
+};
+
+} // namespace
+
+template<>
+inline constexpr bool bpl::enable_trivially_relocatable<Boxed> = true;
+
+TEST(Array, triviallyRelocatable) {
+	static_assert(bpl::trivially_relocatable<int>);
+	static_assert(bpl::trivially_relocatable<Boxed>);
+	static_assert(!bpl::trivially_relocatable<std::vector<int>>);
+
+	bpl::Array<Boxed> array;
+	for (int i = 0; i < 42; ++i) {
+		array.append(i);
+	}
+	array.insert(0, -1);
+	(void) array.remove(21);
+	EXPECT_EQ(array.size(), 42);
+	EXPECT_EQ(*array[0].value, -1);
+	EXPECT_EQ(*array[20].value, 19);
+	EXPECT_EQ(*array[21].value, 21);
+	EXPECT_EQ(*array.back().value, 41);
+}
+
+TEST(Array, shrinkToFit) {
+	bpl::Array<int> array(42, 42);
+	array.reserve(1024);
+	array.shrink_to_fit();
+	EXPECT_LT(array.capacity(), 1024);
+	EXPECT_GE(array.capacity(), 42);
+	EXPECT_EQ(std::ranges::count(array, 42), 42);
+
+	array.clear();
+	array.shrink_to_fit();
+	EXPECT_EQ(array.data(), nullptr);
+	EXPECT_EQ(array.capacity(), 0);
+}
+
+TEST(Array, growInPlace) {
+	bpl::Array<int, bpl::Arena> array(bpl::Arena(4096));
+	array.append_n(16, 42);
+	const int* data = array.data();
+
+	array.reserve(512);
+	EXPECT_EQ(array.data(), data);
+	EXPECT_GE(array.capacity(), 512);
+	EXPECT_EQ(std::ranges::count(array, 42), 16);
+
+	array.shrink_to_fit();
+	EXPECT_EQ(array.data(), data);
+	EXPECT_EQ(array.capacity(), 16);
+	EXPECT_EQ(array.allocator().size(), 16 * sizeof(int));
+}
+
+TEST(Array, growthPolicy) {
+	{
+		bpl::Array<int, bpl::GlobalAllocator, bpl::ExactGrowth> array;
+		array.append_n(16, 42);
+		array.append(42);
+		EXPECT_EQ(array.capacity(), 18); // GlobalAllocator aligns sizes to `sizeof(void*)`
+	}
+	{
+		bpl::Array<int> array;
+		array.append_n(16, 42);
+		array.append(42);
+		EXPECT_EQ(array.capacity(), 32);
+	}
+	{
+		bpl::Array<int, bpl::GlobalAllocator, bpl::HalfGrowth> array;
+		array.append_n(16, 42);
+		array.append(42);
+		EXPECT_EQ(array.capacity(), 24);
+	}
+	{
+		bpl::Array<int, bpl::GlobalAllocator, bpl::PageGrowth<>> array;
+		array.append(42);
+		EXPECT_EQ(array.capacity() * sizeof(int), bpl::get_page_size());
+	}
+}
+
+TEST(Array, swapRemove) {
+	std::array data = { 0, 1, 2, 3, 4 };
+	bpl::Array<int> array(bpl::from_range, data);
+	EXPECT_EQ(array.swap_remove(1), 1);
+	EXPECT_TRUE(std::ranges::equal(array, std::array{ 0, 4, 2, 3 }));
+	EXPECT_EQ(array.swap_remove(3), 3);
+	EXPECT_TRUE(std::ranges::equal(array, std::array{ 0, 4, 2 }));
+}
+
+TEST(Array, removeIf) {
+	std::vector<int> data(100);
+	std::iota(data.begin(), data.end(), 0);
+	bpl::Array<int> array(bpl::from_range, data);
+
+	size_t calls = 0;
+	size_t removed = array.remove_if([&calls](int x) {
+		calls += 1;
+		return x % 3 != 0;
+	});
+	EXPECT_EQ(removed, 66);
+	EXPECT_EQ(calls, 100);
+	EXPECT_EQ(array.size(), 34);
+	for (size_t i = 0; i < array.size(); ++i) {
+		ASSERT_EQ(array[i], static_cast<int>(i * 3));
+	}
+}
+
+TEST(Array, retain) {
+	bpl::Array<std::unique_ptr<int>> array;
+	for (int i = 0; i < 10; ++i) {
+		array.append(std::make_unique<int>(i));
+	}
+	EXPECT_EQ(array.retain([](const std::unique_ptr<int>& x) { return *x >= 7 || *x < 2; }), 5);
+	std::vector<int> values;
+	for (const auto& x : array) {
+		values.push_back(*x);
+	}
+	EXPECT_EQ(values, (std::vector{ 0, 1, 7, 8, 9 }));
+}
+
+TEST(Array, appendUninit) {
+	bpl::Array<uint8_t> array;
+	array.append(0xFF);
+
+	bpl::Span<uint8_t> spare = array.append_uninit(64);
+	EXPECT_EQ(spare.size(), 64);
+	EXPECT_EQ(spare.data(), array.end());
+	EXPECT_EQ(array.size(), 1);
+
+	const std::array<uint8_t, 3> data = { 1, 2, 3 };
+	std::ranges::copy(data, spare.begin());
+	array.commit(data.size());
+	EXPECT_TRUE(std::ranges::equal(array, std::array<uint8_t, 4>{ 0xFF, 1, 2, 3 }));
+
+	spare = array.append_uninit(0);
+	EXPECT_TRUE(spare.empty());
+	array.commit(0);
+	EXPECT_EQ(array.size(), 4);
+}
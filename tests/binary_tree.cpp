@@ -1,9 +1,11 @@
 // Copyright © 2025 Luca Valsassina
 // SPDX-License-Identifier: MIT
 
+#include <bpl/arena.hpp>
 #include <bpl/array.hpp>
 #include <bpl/binary_tree.hpp>
 #include <bpl/span.hpp>
+#include <bpl/tags.hpp>
 
 #include <gtest/gtest.h>
 
@@ -20,3 +22,30 @@ TEST(BinaryTree, defaultConstruct) {
 	tree.traverse_post_order([&values](const bpl::BinaryTreeNode<int>* node) { values.append(node->value); });
 	EXPECT_TRUE(bpl::Span<int>(values) == bpl::Span<int>(std::array{ 3, 2, 1 }));
 }
+
+TEST(BinaryTree, fromRange) {
+	bpl::Arena arena(4096u);
+	bpl::BinaryTree<int, bpl::ArenaRef> tree(bpl::from_range, bpl::ArenaRef(arena), std::array{ 2, 1, 3 });
+	EXPECT_EQ(tree.root->value, 2);
+	EXPECT_EQ(tree.root->left->value, 1);
+	EXPECT_EQ(tree.root->right->value, 3);
+
+	auto values = bpl::Array<int>{};
+	tree.traverse_post_order([&values](const bpl::BinaryTreeNode<int>* node) { values.append(node->value); });
+	EXPECT_TRUE(bpl::Span<int>(values) == bpl::Span<int>(std::array{ 1, 3, 2 }));
+}
+
+TEST(BinaryTree, fromSubtrees) {
+	bpl::Arena arena(4096u);
+	using Tree = bpl::BinaryTree<int, bpl::ArenaRef>;
+	Tree tree(2, Tree(bpl::ArenaRef(arena)), Tree(bpl::ArenaRef(arena)));
+	EXPECT_EQ(tree.root->value, 2);
+	EXPECT_EQ(tree.root->left, nullptr);
+
+	bpl::BinaryTree<int> left(1);
+	bpl::BinaryTree<int> right(3);
+	bpl::BinaryTree<int> joined(2, std::move(left), std::move(right));
+	EXPECT_EQ(left.root, nullptr);
+	EXPECT_EQ(joined.root->left->value, 1);
+	EXPECT_EQ(joined.root->right->value, 3);
+}
@@ -34,3 +34,17 @@ TEST(bit, toSigned) {
 		EXPECT_EQ(std::memcmp(&x, &y, sizeof(unsigned int)), 0);
 	}
 }
+
+TEST(bit, findFirstSet) {
+	static_assert(bpl::find_first_set(1u) == 0);
+	static_assert(bpl::find_first_set(12u) == 2);
+	static_assert(bpl::find_first_set(uint8_t{ 0x80 }) == 7);
+	static_assert(bpl::find_first_set(uint64_t{ 1 } << 63u) == 63);
+}
+
+TEST(bit, findLastSet) {
+	static_assert(bpl::find_last_set(1u) == 0);
+	static_assert(bpl::find_last_set(12u) == 3);
+	static_assert(bpl::find_last_set(uint8_t{ 0xff }) == 7);
+	static_assert(bpl::find_last_set(UINT64_MAX) == 63);
+}
@@ -0,0 +1,141 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/arena.hpp>
+#include <bpl/bucket_array.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/span.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+TEST(BucketArray, constructDefault) {
+	bpl::BucketArray<int> array;
+	EXPECT_TRUE(array.empty());
+	EXPECT_EQ(array.capacity(), 0);
+	EXPECT_EQ(array.bucket_count(), 0);
+}
+
+TEST(BucketArray, stableAddresses) {
+	bpl::BucketArray<int, 4> array;
+	std::vector<int*> addresses;
+	for (int i = 0; i < 100; ++i) {
+		addresses.push_back(&array.append(i));
+	}
+	EXPECT_EQ(array.size(), 100);
+	EXPECT_EQ(array.bucket_count(), 25);
+	for (size_t i = 0; i < addresses.size(); ++i) {
+		ASSERT_EQ(&array[i], addresses[i]);
+		ASSERT_EQ(array[i], static_cast<int>(i));
+	}
+}
+
+TEST(BucketArray, buckets) {
+	bpl::BucketArray<int, 8> array;
+	for (int i = 0; i < 20; ++i) {
+		array.append(i);
+	}
+	ASSERT_EQ(array.bucket_count(), 3);
+	EXPECT_EQ(array.bucket(0).size(), 8);
+	EXPECT_EQ(array.bucket(2).size(), 4);
+
+	int expected = 0;
+	for (size_t i = 0; i < array.bucket_count(); ++i) {
+		for (int x : array.bucket(i)) {
+			ASSERT_EQ(x, expected);
+			expected += 1;
+		}
+	}
+	EXPECT_EQ(expected, 20);
+}
+
+TEST(BucketArray, iterators) {
+	EXPECT_TRUE((std::ranges::forward_range<bpl::BucketArray<int, 4>>));
+	EXPECT_TRUE((std::ranges::forward_range<const bpl::BucketArray<int, 4>>));
+
+	bpl::BucketArray<int, 4> array;
+	EXPECT_EQ(array.begin(), array.end());
+	std::vector<int> expected;
+	for (int i = 0; i < 10; ++i) {
+		array.append(i);
+		expected.push_back(i);
+	}
+	EXPECT_TRUE(std::ranges::equal(array, expected));
+
+	const bpl::BucketArray<int, 4>& const_array = array;
+	int sum = 0;
+	for (const int& x : const_array) {
+		sum += x;
+	}
+	EXPECT_EQ(sum, 45);
+}
+
+TEST(BucketArray, removeLastAndClear) {
+	bpl::BucketArray<std::string, 2> array;
+	array.append(32, 'a');
+	array.append(32, 'b');
+	array.append(32, 'c');
+	EXPECT_EQ(array.remove_last(), std::string(32, 'c'));
+	EXPECT_EQ(array.back(), std::string(32, 'b'));
+
+	const size_t capacity = array.capacity();
+	array.clear();
+	EXPECT_TRUE(array.empty());
+	EXPECT_EQ(array.capacity(), capacity);
+}
+
+TEST(BucketArray, arena) {
+	bpl::BucketArray<int, 16, bpl::Arena> array(bpl::Arena(4096));
+	for (int i = 0; i < 64; ++i) {
+		array.append(i);
+	}
+	EXPECT_EQ(array.back(), 63);
+	EXPECT_GE(array.allocator().size(), 64 * sizeof(int));
+}
+
+namespace {
+
+// A global allocator that counts the blocks that weren't deallocated.
+struct LeakCheckingAllocator {
+	static inline size_t live_blocks = 0;
+
+	static auto allocate(size_t size, size_t alignment) -> bpl::MemoryBlock {
+		live_blocks += 1;
+		return bpl::GlobalAllocator::allocate(size, alignment);
+	}
+
+	static void deallocate(bpl::MemoryBlock block, size_t alignment) {
+		live_blocks -= 1;
+		bpl::GlobalAllocator::deallocate(block, alignment);
+	}
+};
+
+} // namespace
+
+TEST(BucketArray, tableGrowth) {
+	{
+		// Enough buckets to grow the table several times
+		bpl::BucketArray<int, 4, LeakCheckingAllocator> array;
+		for (int i = 0; i < 1000; ++i) {
+			array.append(i);
+		}
+		EXPECT_EQ(array[999], 999);
+		EXPECT_EQ(LeakCheckingAllocator::live_blocks, array.bucket_count() + 1u);
+	}
+	EXPECT_EQ(LeakCheckingAllocator::live_blocks, 0u);
+
+	bpl::BucketArray<int, 4, bpl::Arena> array(bpl::Arena(1u << 20u));
+	for (int i = 0; i < 1000; ++i) {
+		array.append(i);
+	}
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_EQ(array[static_cast<size_t>(i)], i);
+	}
+}
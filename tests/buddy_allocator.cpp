@@ -0,0 +1,119 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/array.hpp>
+#include <bpl/buddy_allocator.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ptr.hpp>
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+TEST(BuddyAllocator, allocatorConcepts) {
+	EXPECT_TRUE(bpl::ResizableAllocator<bpl::BuddyAllocator>);
+	EXPECT_TRUE(bpl::OwningAllocator<bpl::BuddyAllocator>);
+}
+
+TEST(BuddyAllocator, allocate) {
+	bpl::BuddyAllocator buddy(3000u, 64u);
+	EXPECT_EQ(buddy.capacity(), 4096u);
+
+	bpl::MemoryBlock block1 = buddy.allocate(1u, 1u);
+	EXPECT_EQ(block1.size, 64u);
+	bpl::MemoryBlock block2 = buddy.allocate(100u, 8u);
+	EXPECT_EQ(block2.size, 128u);
+	EXPECT_EQ(bpl::ptr_to_addr(block2.ptr) % 128u, 0u);
+	bpl::MemoryBlock block3 = buddy.allocate(2048u, 8u);
+	EXPECT_EQ(block3.size, 2048u);
+	EXPECT_TRUE(buddy.owns(block3));
+
+	// Only 4096 - 2048 - 128 - 64 bytes are left
+	EXPECT_EQ(buddy.allocate(2048u, 8u), bpl::MemoryBlock{});
+	EXPECT_NE(buddy.allocate(1024u, 8u).ptr, nullptr);
+}
+
+TEST(BuddyAllocator, smallerThanPage) {
+	bpl::BuddyAllocator buddy(256u, 64u);
+	EXPECT_EQ(buddy.capacity(), 256u);
+
+	// The rest of the page isn't managed by the allocator
+	EXPECT_EQ(buddy.allocate(512u, 8u), bpl::MemoryBlock{});
+	bpl::MemoryBlock block = buddy.allocate(256u, 8u);
+	ASSERT_NE(block.ptr, nullptr);
+	EXPECT_FALSE(buddy.owns({ .ptr = static_cast<std::byte*>(block.ptr) + 256, .size = 64u }));
+	EXPECT_EQ(buddy.try_grow(block, 8u, 256u), bpl::MemoryBlock{});
+	buddy.deallocate(block, 8u);
+}
+
+TEST(BuddyAllocator, coalesce) {
+	bpl::BuddyAllocator buddy(4096u, 64u);
+	std::vector<bpl::MemoryBlock> blocks;
+	for (size_t i = 0; i < 64u; ++i) {
+		bpl::MemoryBlock block = buddy.allocate(64u, 8u);
+		ASSERT_NE(block.ptr, nullptr);
+		blocks.push_back(block);
+	}
+	EXPECT_EQ(buddy.allocate(64u, 8u), bpl::MemoryBlock{});
+
+	// Deallocating every block merges them back into the whole region
+	for (size_t i = 0; i < blocks.size(); i += 2) {
+		buddy.deallocate(blocks[i], 8u);
+	}
+	for (size_t i = 1; i < blocks.size(); i += 2) {
+		buddy.deallocate(blocks[i], 8u);
+	}
+	bpl::MemoryBlock whole = buddy.allocate(4096u, 8u);
+	EXPECT_EQ(whole.size, 4096u);
+	buddy.deallocate(whole, 8u);
+}
+
+TEST(BuddyAllocator, tryGrow) {
+	bpl::BuddyAllocator buddy(4096u, 64u);
+	bpl::MemoryBlock block1 = buddy.allocate(64u, 8u);
+	bpl::MemoryBlock grown = buddy.try_grow(block1, 8u, 100u);
+	EXPECT_EQ(grown.ptr, block1.ptr);
+	EXPECT_EQ(grown.size, 256u);
+
+	bpl::MemoryBlock block2 = buddy.allocate(256u, 8u);
+	EXPECT_EQ(bpl::ptr_to_addr(block2.ptr), bpl::ptr_to_addr(block1.ptr) + 256u);
+	// The buddy of the grown block is allocated
+	EXPECT_EQ(buddy.try_grow(grown, 8u, 256u), bpl::MemoryBlock{});
+	// An upper half can't grow
+	EXPECT_EQ(buddy.try_grow(block2, 8u, 256u), bpl::MemoryBlock{});
+
+	buddy.deallocate(block2, 8u);
+	EXPECT_EQ(buddy.try_grow(grown, 8u, 3840u).size, 4096u);
+}
+
+TEST(BuddyAllocator, tryShrink) {
+	bpl::BuddyAllocator buddy(4096u, 64u);
+	bpl::MemoryBlock block = buddy.allocate(1024u, 8u);
+	EXPECT_FALSE(buddy.try_shrink(block, 8u, 100u));
+	ASSERT_TRUE(buddy.try_shrink(block, 8u, 128u));
+	// The freed upper halves are reused
+	bpl::MemoryBlock other = buddy.allocate(512u, 8u);
+	EXPECT_EQ(bpl::ptr_to_addr(other.ptr), bpl::ptr_to_addr(block.ptr) + 512u);
+}
+
+TEST(BuddyAllocator, array) {
+	bpl::Array<int, bpl::BuddyAllocator> array(bpl::BuddyAllocator(1u << 20u));
+	for (int i = 0; i < 10000; ++i) {
+		array.append(i);
+	}
+	EXPECT_EQ(array.size(), 10000u);
+	EXPECT_EQ(array[9999], 9999);
+}
+
+TEST(BuddyAllocator, move) {
+	bpl::BuddyAllocator buddy(4096u);
+	bpl::MemoryBlock block = buddy.allocate(64u, 8u);
+	bpl::BuddyAllocator other(std::move(buddy));
+	EXPECT_TRUE(other.owns(block));
+	other.deallocate(block, 8u);
+	EXPECT_EQ(other.allocate(4096u, 8u).size, 4096u);
+}
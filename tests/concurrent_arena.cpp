@@ -0,0 +1,111 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/concurrent_arena.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ptr.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST(ConcurrentArena, allocatorConcepts) {
+	EXPECT_TRUE(bpl::Allocator<bpl::ConcurrentArena>);
+	EXPECT_FALSE(bpl::GrowableAllocator<bpl::ConcurrentArena>);
+}
+
+TEST(ConcurrentArena, push) {
+	bpl::ConcurrentArena arena({ .capacity = 1u << 20u, .sub_block_size = 4096u });
+	EXPECT_TRUE(arena.empty());
+
+	bpl::MemoryBlock block1 = arena.push(16u, 8u);
+	bpl::MemoryBlock block2 = arena.push(32u, 64u);
+	ASSERT_NE(block1.ptr, nullptr);
+	ASSERT_NE(block2.ptr, nullptr);
+	EXPECT_GE(block2.size, 32u);
+	EXPECT_EQ(bpl::ptr_to_addr(block2.ptr) % 64u, 0u);
+	// Both blocks come from the sub-block of this thread
+	EXPECT_EQ(arena.size(), 4096u);
+
+	// Too large for a sub-block
+	bpl::MemoryBlock large = arena.push(8192u, 8u);
+	ASSERT_NE(large.ptr, nullptr);
+	EXPECT_EQ(arena.size(), 4096u + 8192u);
+}
+
+TEST(ConcurrentArena, roundedSize) {
+	constexpr size_t grain = alignof(std::max_align_t);
+	bpl::ConcurrentArena arena({ .capacity = 1u << 20u, .sub_block_size = 4096u });
+
+	// Blocks from the sub-block and from the shared offset are rounded up the same way
+	bpl::MemoryBlock block1 = arena.push(1u, 1u);
+	bpl::MemoryBlock block2 = arena.push(1u, 1u);
+	bpl::MemoryBlock large = arena.push(8192u + 1u, 1u);
+	EXPECT_EQ(block1.size, grain);
+	EXPECT_EQ(block2.size, grain);
+	EXPECT_EQ(large.size, 8192u + grain);
+	EXPECT_EQ(bpl::ptr_to_addr(block1.ptr) + block1.size, bpl::ptr_to_addr(block2.ptr));
+}
+
+TEST(ConcurrentArena, full) {
+	bpl::ConcurrentArena arena({ .capacity = 4096u, .sub_block_size = 1024u });
+	EXPECT_EQ(arena.push(arena.capacity() + 1u, 8u), bpl::MemoryBlock{});
+	EXPECT_NE(arena.push(arena.capacity(), 8u).ptr, nullptr);
+	EXPECT_EQ(arena.push(16u, 8u), bpl::MemoryBlock{});
+
+	arena.clear();
+	EXPECT_TRUE(arena.empty());
+	EXPECT_NE(arena.push(16u, 8u).ptr, nullptr);
+}
+
+TEST(ConcurrentArena, clear) {
+	bpl::ConcurrentArena arena({ .capacity = 1u << 20u, .sub_block_size = 4096u });
+	bpl::MemoryBlock block1 = arena.push(16u, 8u);
+	arena.clear();
+	// The sub-block of this thread is taken again from the beginning of the arena
+	EXPECT_EQ(arena.push(16u, 8u), block1);
+	EXPECT_EQ(arena.size(), 4096u);
+}
+
+TEST(ConcurrentArena, threads) {
+	constexpr size_t thread_count = 4u;
+	constexpr size_t allocation_count = 1000u;
+
+	bpl::ConcurrentArena arena({ .capacity = 1u << 24u, .sub_block_size = 4096u });
+	std::vector<std::vector<bpl::MemoryBlock>> blocks(thread_count);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < thread_count; ++t) {
+		threads.emplace_back([&, t] {
+			for (size_t i = 0; i < allocation_count; ++i) {
+				bpl::MemoryBlock block = arena.push(8u + (i % 5u) * 8u, 8u);
+				std::fill_n(static_cast<char*>(block.ptr), block.size, static_cast<char>(t));
+				blocks[t].push_back(block);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	std::vector<bpl::MemoryBlock> all;
+	for (size_t t = 0; t < thread_count; ++t) {
+		for (bpl::MemoryBlock block : blocks[t]) {
+			ASSERT_NE(block.ptr, nullptr);
+			// No other thread wrote over the block
+			EXPECT_TRUE(std::all_of(static_cast<char*>(block.ptr), static_cast<char*>(block.ptr) + block.size, [&](char c) {
+				return c == static_cast<char>(t);
+			}));
+			all.push_back(block);
+		}
+	}
+	std::sort(all.begin(), all.end(), [](bpl::MemoryBlock a, bpl::MemoryBlock b) { return a.ptr < b.ptr; });
+	for (size_t i = 1; i < all.size(); ++i) {
+		EXPECT_LE(bpl::ptr_to_addr(all[i - 1].ptr) + all[i - 1].size, bpl::ptr_to_addr(all[i].ptr));
+	}
+}
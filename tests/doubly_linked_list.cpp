@@ -1,12 +1,16 @@
 // Copyright © 2025 Luca Valsassina
 // SPDX-License-Identifier: MIT
 
+#include <bpl/arena.hpp>
 #include <bpl/doubly_linked_list.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <iterator>
+#include <numeric>
 #include <ranges>
+#include <vector>
 
 TEST(DoublyLinkedList, concepts) {
 	static_assert(std::forward_iterator<bpl::DoublyLinkedListIterator<int>>);
@@ -31,3 +35,18 @@ TEST(DoublyLinkedList, rangeBasedForLoop) {
 		EXPECT_EQ(k, 10u);
 	}
 }
+
+TEST(DoublyLinkedList, fromIterators) {
+	std::vector<int> values(100u);
+	std::iota(values.begin(), values.end(), 0);
+	bpl::Arena arena(4096u);
+	bpl::DoublyLinkedList<int, bpl::ArenaRef> list(bpl::ArenaRef(arena), values.begin(), values.end());
+	EXPECT_TRUE(std::ranges::equal(list, values));
+
+	// Walks back from the last node
+	auto it = list.begin();
+	std::ranges::advance(it, 99);
+	EXPECT_EQ(*it, 99);
+	--it;
+	EXPECT_EQ(*it, 98);
+}
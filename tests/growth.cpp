@@ -0,0 +1,42 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/growth.hpp>
+#include <bpl/os.hpp>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include <cstddef>
+
+TEST(growth, concepts) {
+	static_assert(bpl::GrowthPolicy<bpl::ExactGrowth>);
+	static_assert(bpl::GrowthPolicy<bpl::DoublingGrowth>);
+	static_assert(bpl::GrowthPolicy<bpl::HalfGrowth>);
+	static_assert(bpl::GrowthPolicy<bpl::PageGrowth<>>);
+	static_assert(bpl::GrowthPolicy<bpl::HugePageGrowth<>>);
+}
+
+TEST(growth, exact) {
+	EXPECT_EQ(bpl::ExactGrowth::grow(64, 65), 65);
+}
+
+TEST(growth, geometric) {
+	EXPECT_EQ(bpl::DoublingGrowth::grow(0, 4), 4);
+	EXPECT_EQ(bpl::DoublingGrowth::grow(64, 65), 128);
+	EXPECT_EQ(bpl::DoublingGrowth::grow(64, 256), 256);
+	EXPECT_EQ(bpl::HalfGrowth::grow(64, 65), 96);
+	EXPECT_EQ(bpl::DoublingGrowth::grow(std::numeric_limits<size_t>::max() / 2 + 1, 42), 42);
+}
+
+TEST(growth, pageRounded) {
+	const size_t page_size = bpl::get_page_size();
+	EXPECT_EQ(bpl::PageGrowth<>::grow(0, 1), page_size);
+	EXPECT_EQ(bpl::PageGrowth<>::grow(page_size, page_size + 1), 2 * page_size);
+	EXPECT_EQ(bpl::PageGrowth<bpl::ExactGrowth>::grow(page_size, page_size + 1), 2 * page_size);
+
+	const size_t huge_page_size = bpl::get_huge_page_size();
+	EXPECT_EQ(bpl::HugePageGrowth<>::grow(huge_page_size, huge_page_size + 1), 2 * huge_page_size);
+	EXPECT_EQ(bpl::HugePageGrowth<bpl::HalfGrowth>::grow(huge_page_size, huge_page_size + 1), 2 * huge_page_size);
+}
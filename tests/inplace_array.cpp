@@ -0,0 +1,79 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/inplace_array.hpp>
+#include <bpl/span.hpp>
+#include <bpl/tags.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST(InplaceArray, traits) {
+	static_assert(std::is_same_v<bpl::InplaceArray<int, 16>::size_type, uint8_t>);
+	static_assert(std::is_same_v<bpl::InplaceArray<int, 1024>::size_type, uint16_t>);
+	static_assert(sizeof(bpl::InplaceArray<uint8_t, 15>) == 16);
+	static_assert(std::is_trivially_copyable_v<bpl::InplaceArray<int, 16>>);
+	static_assert(!std::is_trivially_copyable_v<bpl::InplaceArray<std::string, 16>>);
+}
+
+namespace {
+
+constexpr auto sum_constexpr() -> int {
+	bpl::InplaceArray<int, 8> array;
+	array.append(1);
+	array.append(4);
+	array.insert(1, 2);
+	array.insert(2, 3);
+	(void) array.remove(0);
+	int sum = 0;
+	for (int x : bpl::Span(array)[{ .start = 1 }]) {
+		sum += x;
+	}
+	return sum;
+}
+
+} // namespace
+
+TEST(InplaceArray, constexpr) {
+	static_assert(sum_constexpr() == 7);
+}
+
+TEST(InplaceArray, appendAndRemove) {
+	std::array data = { 0, 1, 2, 3, 4, 5 };
+	bpl::InplaceArray<int, 8> array(bpl::from_range, data);
+	EXPECT_TRUE(std::ranges::equal(array, data));
+
+	EXPECT_TRUE(array.try_append(6));
+	EXPECT_TRUE(array.try_append(7));
+	EXPECT_TRUE(array.full());
+	EXPECT_FALSE(array.try_append(8));
+
+	array.remove(2, 6);
+	EXPECT_TRUE(std::ranges::equal(array, std::array{ 0, 1, 6, 7 }));
+
+	array.insert_range(2, std::array{ 2, 3 });
+	EXPECT_TRUE(std::ranges::equal(array, std::array{ 0, 1, 2, 3, 6, 7 }));
+}
+
+TEST(InplaceArray, nonTrivial) {
+	bpl::InplaceArray<std::string, 4> array(2, 64, 'x');
+	array.insert(0, "a");
+	EXPECT_EQ(array.size(), 3);
+	EXPECT_EQ(array.front(), "a");
+	EXPECT_EQ(array.back(), std::string(64, 'x'));
+
+	bpl::InplaceArray<std::string, 4> copy(array);
+	EXPECT_TRUE(std::ranges::equal(array, copy));
+
+	bpl::InplaceArray<std::string, 4> moved(std::move(array));
+	EXPECT_TRUE(std::ranges::equal(moved, copy));
+	EXPECT_TRUE(array.empty()); // NOLINT(bugprone-use-after-move)
+}
@@ -1,7 +1,9 @@
 // Copyright © 2025 Luca Valsassina
 // SPDX-License-Identifier: MIT
 
+#include <bpl/allocator.hpp>
 #include <bpl/linked_list.hpp>
+#include <bpl/pool_allocator.hpp>
 
 #include <gtest/gtest.h>
 
@@ -24,3 +26,26 @@ TEST(LinkedList, rangeBasedForLoop) {
 	}
 	EXPECT_EQ(i, 10u);
 }
+
+TEST(LinkedList, batchAllocation) {
+	using Pool = bpl::PoolAllocator<sizeof(bpl::LinkedListNode<int>), alignof(bpl::LinkedListNode<int>)>;
+	using List = bpl::LinkedList<int, bpl::AllocatorRef<Pool>>;
+
+	Pool pool(16u);
+	int data[200];
+	for (int i = 0; i < 200; ++i) {
+		data[i] = i;
+	}
+	{
+		List list(bpl::AllocatorRef<Pool>(pool), data, 200u);
+		int k = 0;
+		for (int x : list) {
+			EXPECT_EQ(x, k);
+			k += 1;
+		}
+		EXPECT_EQ(k, 200);
+	}
+	// The nodes went back to the pool
+	List list(bpl::AllocatorRef<Pool>(pool), 200u, 7);
+	EXPECT_EQ(std::ranges::distance(list), 200);
+}
@@ -2,3 +2,59 @@
 // SPDX-License-Identifier: MIT
 
 #include <bpl/memory.hpp>
+#include <bpl/span.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+
+#include <cstddef>
+
+TEST(memory, relocateTrivial) {
+	std::array src = { 1, 2, 3, 4 };
+	std::array<int, 4> dst = {};
+	EXPECT_EQ(bpl::relocate(src, dst), 4);
+	EXPECT_EQ(dst, src);
+}
+
+TEST(memory, relocateOverlapping) {
+	std::array data = { 0, 1, 2, 3, 4 };
+	EXPECT_EQ(bpl::relocate_backward(bpl::Span(data.data(), 3), bpl::Span(data.data() + 1, 4)), 3);
+	EXPECT_EQ(data, (std::array{ 0, 1, 0, 1, 2 }));
+	EXPECT_EQ(bpl::relocate(bpl::Span(data.data() + 1, 4), bpl::Span(data.data(), 4)), 4);
+	EXPECT_EQ(data, (std::array{ 1, 0, 1, 2, 2 }));
+}
+
+TEST(memory, relocateNonTrivial) {
+	static_assert(!bpl::trivially_relocatable<std::string>);
+
+	alignas(std::string) std::byte src_storage[2 * sizeof(std::string)];
+	alignas(std::string) std::byte dst_storage[2 * sizeof(std::string)];
+	bpl::Span src(reinterpret_cast<std::string*>(src_storage), 2);
+	bpl::Span dst(reinterpret_cast<std::string*>(dst_storage), 2);
+	std::construct_at(src.data(), 64, 'a');
+	std::construct_at(src.data() + 1, 64, 'b');
+
+	EXPECT_EQ(bpl::relocate(src, dst), 2);
+	EXPECT_EQ(dst[0], std::string(64, 'a'));
+	EXPECT_EQ(dst[1], std::string(64, 'b'));
+	EXPECT_EQ(bpl::destroy(dst), 2);
+}
+
+namespace {
+
+constexpr auto relocate_constexpr() -> int {
+	std::array src = { 1, 2, 3 };
+	std::array<int, 3> dst = {};
+	bpl::relocate(src, dst);
+	return dst[0] + dst[1] + dst[2];
+}
+
+} // namespace
+
+TEST(memory, relocateConstexpr) {
+	static_assert(relocate_constexpr() == 6);
+}
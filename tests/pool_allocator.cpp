@@ -0,0 +1,104 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/pool_allocator.hpp>
+#include <bpl/ptr.hpp>
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+TEST(PoolAllocator, allocatorConcepts) {
+	EXPECT_TRUE((bpl::Allocator<bpl::PoolAllocator<16, 8>>));
+}
+
+TEST(PoolAllocator, blockSize) {
+	EXPECT_EQ((bpl::PoolAllocator<1, 1>::block_size), sizeof(void*));
+	EXPECT_EQ((bpl::PoolAllocator<24, 16>::block_size), 32u);
+	EXPECT_EQ((bpl::PoolAllocator<24, 16>::block_alignment), 16u);
+}
+
+TEST(PoolAllocator, allocate) {
+	bpl::PoolAllocator<24, 16> pool(4u);
+	std::vector<bpl::MemoryBlock> blocks;
+	for (size_t i = 0; i < 10u; ++i) {
+		bpl::MemoryBlock block = pool.allocate(24u, 16u);
+		ASSERT_NE(block.ptr, nullptr);
+		EXPECT_EQ(block.size, 32u);
+		EXPECT_EQ(bpl::ptr_to_addr(block.ptr) % 16u, 0u);
+		blocks.push_back(block);
+	}
+	for (size_t i = 1; i < blocks.size(); ++i) {
+		EXPECT_NE(blocks[i - 1].ptr, blocks[i].ptr);
+	}
+
+	EXPECT_EQ(pool.allocate(33u, 16u), bpl::MemoryBlock{});
+	EXPECT_EQ(pool.allocate(24u, 32u), bpl::MemoryBlock{});
+}
+
+TEST(PoolAllocator, deallocate) {
+	bpl::PoolAllocator<16, 8> pool;
+	bpl::MemoryBlock block1 = pool.allocate(16u, 8u);
+	bpl::MemoryBlock block2 = pool.allocate(16u, 8u);
+	pool.deallocate(block1, 8u);
+	pool.deallocate(block2, 8u);
+
+	// The most recently deallocated block is reused first
+	EXPECT_EQ(pool.allocate(16u, 8u), block2);
+	EXPECT_EQ(pool.allocate(16u, 8u), block1);
+}
+
+TEST(PoolAllocator, release) {
+	bpl::PoolAllocator<16, 8> pool(2u);
+	for (size_t i = 0; i < 5u; ++i) {
+		EXPECT_NE(pool.allocate(16u, 8u).ptr, nullptr);
+	}
+	pool.release();
+	EXPECT_NE(pool.allocate(16u, 8u).ptr, nullptr);
+}
+
+TEST(PoolAllocator, move) {
+	bpl::PoolAllocator<16, 8> pool;
+	bpl::MemoryBlock block = pool.allocate(16u, 8u);
+	pool.deallocate(block, 8u);
+
+	bpl::PoolAllocator<16, 8> other(std::move(pool));
+	EXPECT_EQ(other.allocate(16u, 8u), block);
+}
+
+TEST(PoolAllocator, upstream) {
+	bpl::PoolAllocator<64, 64, bpl::PagesAllocator> pool(bpl::PagesAllocator{}, 16u);
+	EXPECT_EQ(pool.blocks_per_slab(), 16u);
+	bpl::MemoryBlock block = pool.allocate(64u, 64u);
+	ASSERT_NE(block.ptr, nullptr);
+	EXPECT_EQ(bpl::ptr_to_addr(block.ptr) % 64u, 0u);
+}
+
+TEST(PoolAllocator, batch) {
+	EXPECT_TRUE((bpl::BatchAllocator<bpl::PoolAllocator<16, 8>>));
+
+	bpl::PoolAllocator<24, 16> pool(4u);
+	bpl::MemoryBlock first = pool.allocate(24u, 16u);
+	pool.deallocate(first, 16u);
+
+	// Takes the free block first, then carves the rest from three slabs
+	bpl::MemoryBlock blocks[10];
+	ASSERT_TRUE(pool.allocate_batch(24u, 16u, 10u, blocks));
+	EXPECT_EQ(blocks[0], first);
+	for (size_t i = 0; i < 10u; ++i) {
+		EXPECT_EQ(blocks[i].size, 32u);
+		EXPECT_EQ(bpl::ptr_to_addr(blocks[i].ptr) % 16u, 0u);
+		for (size_t j = 0; j < i; ++j) {
+			EXPECT_NE(blocks[i].ptr, blocks[j].ptr);
+		}
+	}
+	EXPECT_FALSE(pool.allocate_batch(33u, 16u, 2u, blocks));
+
+	pool.deallocate_batch(blocks, 10u, 16u);
+	EXPECT_EQ(pool.allocate(24u, 16u), blocks[0]);
+}
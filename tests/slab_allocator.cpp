@@ -0,0 +1,102 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/array.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ptr.hpp>
+#include <bpl/slab_allocator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+TEST(SlabAllocator, allocatorConcepts) {
+	EXPECT_TRUE(bpl::Allocator<bpl::SlabAllocator>);
+	EXPECT_TRUE(bpl::BatchAllocator<bpl::SlabAllocator>);
+}
+
+TEST(SlabAllocator, sizeClasses) {
+	bpl::MemoryBlock block1 = bpl::SlabAllocator::allocate(1u, 1u);
+	EXPECT_EQ(block1.size, bpl::SlabAllocator::min_small_size);
+	bpl::MemoryBlock block2 = bpl::SlabAllocator::allocate(100u, 8u);
+	EXPECT_EQ(block2.size, 128u);
+	EXPECT_EQ(bpl::ptr_to_addr(block2.ptr) % 128u, 0u);
+	bpl::MemoryBlock block3 = bpl::SlabAllocator::allocate(16u, 256u);
+	EXPECT_EQ(block3.size, 256u);
+	EXPECT_EQ(bpl::ptr_to_addr(block3.ptr) % 256u, 0u);
+
+	bpl::SlabAllocator::deallocate(block3, 256u);
+	bpl::SlabAllocator::deallocate(block2, 8u);
+	bpl::SlabAllocator::deallocate(block1, 1u);
+}
+
+TEST(SlabAllocator, reuse) {
+	bpl::MemoryBlock block = bpl::SlabAllocator::allocate(48u, 8u);
+	bpl::SlabAllocator::deallocate(block, 8u);
+	EXPECT_EQ(bpl::SlabAllocator::allocate(64u, 8u), block);
+	bpl::SlabAllocator::deallocate(block, 8u);
+}
+
+TEST(SlabAllocator, batch) {
+	bpl::MemoryBlock blocks[100];
+	ASSERT_TRUE(bpl::SlabAllocator::allocate_batch(40u, 8u, 100u, blocks));
+	for (bpl::MemoryBlock block : blocks) {
+		EXPECT_EQ(block.size, 64u);
+		EXPECT_EQ(bpl::ptr_to_addr(block.ptr) % 64u, 0u);
+	}
+	bpl::SlabAllocator::deallocate_batch(blocks, 100u, 8u);
+
+	// The blocks are reused, most recently deallocated first
+	EXPECT_EQ(bpl::SlabAllocator::allocate(64u, 8u), blocks[0]);
+	bpl::SlabAllocator::deallocate(blocks[0], 8u);
+}
+
+TEST(SlabAllocator, large) {
+	bpl::MemoryBlock block = bpl::SlabAllocator::allocate(bpl::SlabAllocator::max_small_size + 1u, 8u);
+	ASSERT_NE(block.ptr, nullptr);
+	EXPECT_GT(block.size, bpl::SlabAllocator::max_small_size);
+	static_cast<char*>(block.ptr)[block.size - 1] = 42;
+	bpl::SlabAllocator::deallocate(block, 8u);
+}
+
+TEST(SlabAllocator, array) {
+	bpl::Array<int, bpl::SlabAllocator> array;
+	for (int i = 0; i < 10000; ++i) {
+		array.append(i);
+	}
+	EXPECT_EQ(array[9999], 9999);
+}
+
+TEST(SlabAllocator, crossThreadDeallocate) {
+	constexpr size_t count = 2000u;
+
+	std::vector<bpl::MemoryBlock> blocks;
+	for (size_t i = 0; i < count; ++i) {
+		bpl::MemoryBlock block = bpl::SlabAllocator::allocate(32u, 8u);
+		std::fill_n(static_cast<char*>(block.ptr), block.size, 1);
+		blocks.push_back(block);
+	}
+	std::thread([&] {
+		for (bpl::MemoryBlock block : blocks) {
+			bpl::SlabAllocator::deallocate(block, 8u);
+		}
+	}).join();
+
+	// The blocks deallocated by the other thread are reused by this one
+	std::vector<bpl::MemoryBlock> reused;
+	for (size_t i = 0; i < count; ++i) {
+		reused.push_back(bpl::SlabAllocator::allocate(32u, 8u));
+	}
+	const size_t reused_count = static_cast<size_t>(std::count_if(reused.begin(), reused.end(), [&](bpl::MemoryBlock b) {
+		return std::find(blocks.begin(), blocks.end(), b) != blocks.end();
+	}));
+	EXPECT_GT(reused_count, count / 2u);
+	for (bpl::MemoryBlock block : reused) {
+		bpl::SlabAllocator::deallocate(block, 8u);
+	}
+}
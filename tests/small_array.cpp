@@ -0,0 +1,90 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/small_array.hpp>
+#include <bpl/span.hpp>
+#include <bpl/tags.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#include <cstddef>
+
+TEST(SmallArray, constructDefault) {
+	bpl::SmallArray<int, 16> array;
+
+	EXPECT_TRUE(array.empty());
+	EXPECT_TRUE(array.is_inline());
+	EXPECT_EQ(array.capacity(), 16);
+	EXPECT_EQ(array.size(), 0);
+}
+
+TEST(SmallArray, appendInline) {
+	bpl::SmallArray<int, 16> array;
+	for (int i = 0; i < 16; ++i) {
+		array.append(i);
+	}
+	EXPECT_TRUE(array.is_inline());
+	EXPECT_EQ(array.size(), 16);
+	EXPECT_EQ(array.front(), 0);
+	EXPECT_EQ(array.back(), 15);
+}
+
+TEST(SmallArray, spill) {
+	std::array<int, 42> data{};
+	std::iota(data.begin(), data.end(), 0);
+
+	bpl::SmallArray<int, 16> array(bpl::from_range, data);
+	EXPECT_FALSE(array.is_inline());
+	EXPECT_TRUE(std::ranges::equal(array, data));
+
+	array.remove(16, array.size());
+	array.shrink_to_fit();
+	EXPECT_TRUE(array.is_inline());
+	EXPECT_TRUE(std::ranges::equal(bpl::Span(array), bpl::Span(data.data(), 16)));
+}
+
+TEST(SmallArray, insertAndRemove) {
+	bpl::SmallArray<std::string, 2> array;
+	array.append("b");
+	array.insert(0, "a");
+	array.insert(2, "d");
+	array.insert(2, "c");
+	EXPECT_FALSE(array.is_inline());
+	EXPECT_TRUE(std::ranges::equal(array, std::array<std::string, 4>{ "a", "b", "c", "d" }));
+
+	EXPECT_EQ(array.remove(1), "b");
+	EXPECT_TRUE(std::ranges::equal(array, std::array<std::string, 3>{ "a", "c", "d" }));
+}
+
+TEST(SmallArray, move) {
+	{
+		bpl::SmallArray<std::string, 4> array(2, "x");
+		bpl::SmallArray<std::string, 4> other(std::move(array));
+		EXPECT_TRUE(other.is_inline());
+		EXPECT_EQ(other.size(), 2);
+		EXPECT_EQ(other[1], "x");
+		EXPECT_TRUE(array.empty()); // NOLINT(bugprone-use-after-move)
+	}
+	{
+		bpl::SmallArray<std::string, 4> array(8, "x");
+		const std::string* data = array.data();
+		bpl::SmallArray<std::string, 4> other;
+		other = std::move(array);
+		EXPECT_EQ(other.data(), data);
+		EXPECT_EQ(other.size(), 8);
+		EXPECT_TRUE(array.is_inline()); // NOLINT(bugprone-use-after-move)
+	}
+}
+
+TEST(SmallArray, copy) {
+	bpl::SmallArray<int, 4> array(8, 42);
+	bpl::SmallArray<int, 4> other(array);
+	EXPECT_TRUE(std::ranges::equal(array, other));
+	EXPECT_NE(array.data(), other.data());
+}
@@ -0,0 +1,89 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/arena.hpp>
+#include <bpl/growth.hpp>
+#include <bpl/os.hpp>
+#include <bpl/ptr.hpp>
+#include <bpl/soa_array.hpp>
+#include <bpl/span.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST(SoAArray, constructDefault) {
+	bpl::SoAArray<int, double> array;
+	EXPECT_TRUE(array.empty());
+	EXPECT_EQ(array.capacity(), 0);
+	EXPECT_TRUE(array.column<0>().empty());
+}
+
+TEST(SoAArray, append) {
+	bpl::SoAArray<uint32_t, double, uint8_t> array;
+	for (uint32_t i = 0; i < 100; ++i) {
+		array.append(i, static_cast<double>(i) / 2, static_cast<uint8_t>(i % 2));
+	}
+	EXPECT_EQ(array.size(), 100);
+	bpl::Span<uint32_t> ids = array.column<0>();
+	bpl::Span<double> values = array.column<1>();
+	bpl::Span<uint8_t> flags = array.column<2>();
+	for (uint32_t i = 0; i < 100; ++i) {
+		ASSERT_EQ(ids[i], i);
+		ASSERT_EQ(values[i], static_cast<double>(i) / 2);
+		ASSERT_EQ(flags[i], i % 2);
+	}
+	EXPECT_EQ(bpl::ptr_to_addr(ids.data()) % bpl::CACHE_LINE_SIZE, 0);
+	EXPECT_EQ(bpl::ptr_to_addr(values.data()) % bpl::CACHE_LINE_SIZE, 0);
+	EXPECT_EQ(bpl::ptr_to_addr(flags.data()) % bpl::CACHE_LINE_SIZE, 0);
+}
+
+TEST(SoAArray, remove) {
+	bpl::SoAArray<int, std::string> array;
+	for (int i = 0; i < 5; ++i) {
+		array.append(i, std::string(32, static_cast<char>('a' + i)));
+	}
+
+	array.remove(1);
+	EXPECT_TRUE(std::ranges::equal(array.column<0>(), std::array{ 0, 2, 3, 4 }));
+	EXPECT_EQ(array.column<1>()[1], std::string(32, 'c'));
+
+	array.swap_remove(0);
+	EXPECT_TRUE(std::ranges::equal(array.column<0>(), std::array{ 4, 2, 3 }));
+	EXPECT_EQ(array.column<1>()[0], std::string(32, 'e'));
+}
+
+TEST(SoAArray, customAllocator) {
+	bpl::BasicSoAArray<bpl::Arena, bpl::DoublingGrowth, int, float> array(bpl::Arena(4096));
+	array.reserve(16);
+	for (int i = 0; i < 16; ++i) {
+		array.append(i, static_cast<float>(i));
+	}
+	EXPECT_EQ(array.capacity(), 16);
+	EXPECT_EQ(array.column<0>().back(), 15);
+	EXPECT_EQ(array.column<1>().back(), 15.0F);
+}
+
+TEST(SoAArray, growthPolicy) {
+	constexpr size_t record_size = sizeof(int) + sizeof(double);
+	constexpr size_t padding = 2 * bpl::CACHE_LINE_SIZE;
+
+	// The policy grows the block by bytes, and each column is padded to a cache line
+	bpl::BasicSoAArray<bpl::GlobalAllocator, bpl::ExactGrowth, int, double> exact;
+	exact.append(0, 0.0);
+	EXPECT_EQ(exact.capacity(), bpl::CACHE_LINE_SIZE / sizeof(double));
+
+	bpl::BasicSoAArray<bpl::GlobalAllocator, bpl::PageGrowth<>, int, double> paged;
+	paged.append(0, 0.0);
+	EXPECT_LE(paged.capacity() * record_size, bpl::get_page_size() + padding);
+	EXPECT_GE(paged.capacity() * record_size, bpl::get_page_size() - padding);
+	for (int i = 1; i < 1000; ++i) {
+		paged.append(i, static_cast<double>(i));
+	}
+	EXPECT_EQ(paged.column<0>()[999], 999);
+}
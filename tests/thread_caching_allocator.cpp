@@ -0,0 +1,200 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/array.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ptr.hpp>
+#include <bpl/thread_caching_allocator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <cstddef>
+
+namespace {
+
+// A global allocator that counts the blocks allocated from it.
+struct CountingAllocator {
+	static inline size_t allocations = 0;
+
+	static auto allocate(size_t size, size_t alignment) -> bpl::MemoryBlock {
+		allocations += 1;
+		return bpl::GlobalAllocator::allocate(size, alignment);
+	}
+
+	static void deallocate(bpl::MemoryBlock block, size_t alignment) { bpl::GlobalAllocator::deallocate(block, alignment); }
+};
+
+using CachingAllocator = bpl::ThreadCachingAllocator<CountingAllocator>;
+
+} // namespace
+
+TEST(ThreadCachingAllocator, allocatorConcepts) {
+	EXPECT_TRUE(bpl::Allocator<bpl::ThreadCachingAllocator<>>);
+}
+
+TEST(ThreadCachingAllocator, sizeClasses) {
+	bpl::MemoryBlock block1 = CachingAllocator::allocate(1u, 1u);
+	EXPECT_EQ(block1.size, CachingAllocator::min_cached_size);
+	bpl::MemoryBlock block2 = CachingAllocator::allocate(100u, 8u);
+	EXPECT_EQ(block2.size, 128u);
+	EXPECT_EQ(bpl::ptr_to_addr(block2.ptr) % 128u, 0u);
+	bpl::MemoryBlock block3 = CachingAllocator::allocate(16u, 256u);
+	EXPECT_EQ(block3.size, 256u);
+	EXPECT_EQ(bpl::ptr_to_addr(block3.ptr) % 256u, 0u);
+
+	CachingAllocator::deallocate(block3, 256u);
+	CachingAllocator::deallocate(block2, 8u);
+	CachingAllocator::deallocate(block1, 1u);
+}
+
+TEST(ThreadCachingAllocator, reuse) {
+	bpl::MemoryBlock block = CachingAllocator::allocate(48u, 8u);
+	CachingAllocator::deallocate(block, 8u);
+
+	const size_t allocations = CountingAllocator::allocations;
+	EXPECT_EQ(CachingAllocator::allocate(64u, 8u), block);
+	EXPECT_EQ(CountingAllocator::allocations, allocations);
+	CachingAllocator::deallocate(block, 8u);
+}
+
+TEST(ThreadCachingAllocator, large) {
+	bpl::MemoryBlock block = CachingAllocator::allocate(CachingAllocator::max_cached_size + 1u, 8u);
+	ASSERT_NE(block.ptr, nullptr);
+	EXPECT_GT(block.size, CachingAllocator::max_cached_size);
+	static_cast<char*>(block.ptr)[block.size - 1] = 42;
+	CachingAllocator::deallocate(block, 8u);
+}
+
+TEST(ThreadCachingAllocator, array) {
+	bpl::Array<int, CachingAllocator> array;
+	for (int i = 0; i < 10000; ++i) {
+		array.append(i);
+	}
+	EXPECT_EQ(array[9999], 9999);
+}
+
+TEST(ThreadCachingAllocator, crossThreadDeallocate) {
+	constexpr size_t count = 4u * CachingAllocator::batch_size;
+
+	std::vector<bpl::MemoryBlock> blocks;
+	for (size_t i = 0; i < count; ++i) {
+		bpl::MemoryBlock block = CachingAllocator::allocate(512u, 8u);
+		std::fill_n(static_cast<char*>(block.ptr), block.size, 1);
+		blocks.push_back(block);
+	}
+	// The other thread moves the blocks to the depot when it overflows and when it exits
+	std::thread([&] {
+		for (bpl::MemoryBlock block : blocks) {
+			CachingAllocator::deallocate(block, 8u);
+		}
+	}).join();
+
+	const size_t allocations = CountingAllocator::allocations;
+	std::vector<bpl::MemoryBlock> reused;
+	for (size_t i = 0; i < count; ++i) {
+		reused.push_back(CachingAllocator::allocate(512u, 8u));
+	}
+	EXPECT_EQ(CountingAllocator::allocations, allocations);
+	EXPECT_TRUE(std::is_permutation(blocks.begin(), blocks.end(), reused.begin()));
+
+	for (bpl::MemoryBlock block : reused) {
+		CachingAllocator::deallocate(block, 8u);
+	}
+}
+
+namespace {
+
+// A global allocator that returns blocks of exactly the requested size.
+struct ExactAllocator {
+	static auto allocate(size_t size, size_t alignment) -> bpl::MemoryBlock {
+		return { .ptr = bpl::GlobalAllocator::allocate(size, alignment).ptr, .size = size };
+	}
+
+	static void deallocate(bpl::MemoryBlock block, size_t alignment) {
+		bpl::GlobalAllocator::deallocate(block, alignment);
+	}
+};
+
+} // namespace
+
+TEST(ThreadCachingAllocator, largeAlignment) {
+	using Allocator = bpl::ThreadCachingAllocator<ExactAllocator>;
+	constexpr size_t alignment = 2 * Allocator::max_cached_size;
+
+	// The block comes from the upstream allocator because of its alignment, and must go back to it
+	bpl::MemoryBlock block = Allocator::allocate(100u, alignment);
+	ASSERT_NE(block.ptr, nullptr);
+	EXPECT_EQ(block.size, 100u);
+	EXPECT_EQ(bpl::ptr_to_addr(block.ptr) % alignment, 0u);
+	Allocator::deallocate(block, alignment);
+
+	bpl::MemoryBlock small = Allocator::allocate(128u, 8u);
+	EXPECT_NE(small.ptr, block.ptr);
+	std::fill_n(static_cast<char*>(small.ptr), small.size, 1);
+	Allocator::deallocate(small, 8u);
+}
+
+TEST(ThreadCachingAllocator, threadExit) {
+	constexpr size_t batch_size = CachingAllocator::batch_size;
+
+	// The thread exits with a full batch and a few more blocks
+	std::thread([] {
+		std::vector<bpl::MemoryBlock> blocks;
+		for (size_t i = 0; i < batch_size + 5u; ++i) {
+			blocks.push_back(CachingAllocator::allocate(4096u, 8u));
+		}
+		for (bpl::MemoryBlock block : blocks) {
+			CachingAllocator::deallocate(block, 8u);
+		}
+	}).join();
+
+	// Only the full batch is in the depot
+	const size_t allocations = CountingAllocator::allocations;
+	std::vector<bpl::MemoryBlock> blocks;
+	for (size_t i = 0; i < batch_size; ++i) {
+		blocks.push_back(CachingAllocator::allocate(4096u, 8u));
+	}
+	EXPECT_EQ(CountingAllocator::allocations, allocations);
+	blocks.push_back(CachingAllocator::allocate(4096u, 8u));
+	EXPECT_EQ(CountingAllocator::allocations, allocations + 1u);
+
+	for (bpl::MemoryBlock block : blocks) {
+		CachingAllocator::deallocate(block, 8u);
+	}
+}
+
+TEST(ThreadCachingAllocator, overflowKeepsRecentBlocks) {
+	constexpr size_t batch_size = CachingAllocator::batch_size;
+
+	std::thread([] {
+		std::vector<bpl::MemoryBlock> blocks;
+		for (size_t i = 0; i < (2 * batch_size) + 1; ++i) {
+			blocks.push_back(CachingAllocator::allocate(8192u, 8u));
+		}
+		for (bpl::MemoryBlock block : blocks) {
+			CachingAllocator::deallocate(block, 8u);
+		}
+
+		// The thread keeps the most recently deallocated blocks
+		bpl::MemoryBlock block = CachingAllocator::allocate(8192u, 8u);
+		EXPECT_EQ(block, blocks.back());
+		CachingAllocator::deallocate(block, 8u);
+
+		// The first deallocated blocks moved to the depot
+		std::thread([&] {
+			std::vector<bpl::MemoryBlock> depot_blocks;
+			for (size_t i = 0; i < batch_size; ++i) {
+				depot_blocks.push_back(CachingAllocator::allocate(8192u, 8u));
+			}
+			EXPECT_TRUE(std::is_permutation(depot_blocks.begin(), depot_blocks.end(), blocks.begin()));
+			for (bpl::MemoryBlock depot_block : depot_blocks) {
+				CachingAllocator::deallocate(depot_block, 8u);
+			}
+		}).join();
+	}).join();
+}
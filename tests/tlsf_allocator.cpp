@@ -0,0 +1,101 @@
+// Copyright © 2025 Luca Valsassina
+// SPDX-License-Identifier: MIT
+
+#include <bpl/allocator.hpp>
+#include <bpl/array.hpp>
+#include <bpl/memory.hpp>
+#include <bpl/ptr.hpp>
+#include <bpl/tlsf_allocator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+TEST(TlsfAllocator, allocatorConcepts) {
+	EXPECT_TRUE(bpl::ResizableAllocator<bpl::TlsfAllocator>);
+	EXPECT_TRUE(bpl::OwningAllocator<bpl::TlsfAllocator>);
+}
+
+TEST(TlsfAllocator, allocate) {
+	bpl::TlsfAllocator tlsf(1u << 16u);
+	bpl::MemoryBlock block1 = tlsf.allocate(1u, 1u);
+	ASSERT_NE(block1.ptr, nullptr);
+	EXPECT_GE(block1.size, 1u);
+	EXPECT_EQ(bpl::ptr_to_addr(block1.ptr) % 16u, 0u);
+
+	bpl::MemoryBlock block2 = tlsf.allocate(1000u, 256u);
+	ASSERT_NE(block2.ptr, nullptr);
+	EXPECT_GE(block2.size, 1000u);
+	EXPECT_EQ(bpl::ptr_to_addr(block2.ptr) % 256u, 0u);
+	EXPECT_TRUE(tlsf.owns(block2));
+
+	EXPECT_EQ(tlsf.allocate(tlsf.capacity(), 8u), bpl::MemoryBlock{});
+	tlsf.deallocate(block1, 1u);
+	tlsf.deallocate(block2, 256u);
+}
+
+TEST(TlsfAllocator, merge) {
+	bpl::TlsfAllocator tlsf(1u << 16u);
+	bpl::MemoryBlock whole = tlsf.allocate(60000u, 8u);
+	ASSERT_NE(whole.ptr, nullptr);
+	tlsf.deallocate(whole, 8u);
+
+	std::vector<bpl::MemoryBlock> blocks;
+	for (size_t i = 0; i < 100u; ++i) {
+		blocks.push_back(tlsf.allocate(16u + (i % 7u) * 40u, 8u));
+		ASSERT_NE(blocks.back().ptr, nullptr);
+	}
+	std::shuffle(blocks.begin(), blocks.end(), std::mt19937(42u));
+	for (bpl::MemoryBlock block : blocks) {
+		tlsf.deallocate(block, 8u);
+	}
+
+	// The free blocks are merged back
+	EXPECT_EQ(tlsf.allocate(60000u, 8u), whole);
+}
+
+TEST(TlsfAllocator, tryGrow) {
+	bpl::TlsfAllocator tlsf(1u << 16u);
+	bpl::MemoryBlock block1 = tlsf.allocate(64u, 8u);
+	bpl::MemoryBlock grown = tlsf.try_grow(block1, 8u, 1000u);
+	EXPECT_EQ(grown.ptr, block1.ptr);
+	EXPECT_GE(grown.size, 1064u);
+
+	bpl::MemoryBlock block2 = tlsf.allocate(64u, 8u);
+	EXPECT_EQ(tlsf.try_grow(grown, 8u, 64u), bpl::MemoryBlock{});
+	tlsf.deallocate(block2, 8u);
+	EXPECT_NE(tlsf.try_grow(grown, 8u, 64u).ptr, nullptr);
+}
+
+TEST(TlsfAllocator, tryShrink) {
+	bpl::TlsfAllocator tlsf(1u << 16u);
+	bpl::MemoryBlock block1 = tlsf.allocate(1024u, 8u);
+	ASSERT_TRUE(tlsf.try_shrink(block1, 8u, 64u));
+
+	// The memory given back is reused
+	bpl::MemoryBlock block2 = tlsf.allocate(512u, 8u);
+	EXPECT_LT(bpl::ptr_to_addr(block2.ptr), bpl::ptr_to_addr(block1.ptr) + 1024u);
+}
+
+TEST(TlsfAllocator, array) {
+	bpl::Array<int, bpl::TlsfAllocator> array(bpl::TlsfAllocator(1u << 20u));
+	for (int i = 0; i < 10000; ++i) {
+		array.append(i);
+	}
+	EXPECT_EQ(array[9999], 9999);
+	array.shrink_to_fit();
+	EXPECT_EQ(array.capacity(), 10000u);
+}
+
+TEST(TlsfAllocator, move) {
+	bpl::TlsfAllocator tlsf(4096u);
+	bpl::MemoryBlock block = tlsf.allocate(64u, 8u);
+	bpl::TlsfAllocator other(std::move(tlsf));
+	other.deallocate(block, 8u);
+	EXPECT_EQ(other.allocate(64u, 8u), block);
+}